@@ -0,0 +1,244 @@
+// frogger_bench_lanes: lane kernels against the pre-specialization lane.
+//
+//   frogger_bench_lanes [gridW ...]      (default: 15 60 240)
+//
+// Builds a few thousand generated rows (Safe and traffic, as a match lays them out)
+// and times Update, visible-vehicle iteration and swept collision per lane for:
+//   ref      - BranchyLane below: the old per-call tests on type and direction, full pattern scan
+//   dispatch - Lane's public entry points, one switch on the lane kind per call
+//   grouped  - rows grouped by (type, direction) once, specialized kernels called
+//              directly and Safe rows never visited (what Game does)
+// The last column is ref time over grouped time (collision: over dispatch, since Game
+// only ever tests the frog's own row).
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+#include "game.h"
+#include "lane.h"
+
+namespace {
+
+// The lane as it was before the specialized kernels, kept as the benchmark's reference.
+// Every call tests the lane type, every vehicle tests the direction, and every query
+// walks the whole pattern. Update and collision lived in lane.cpp, so callers in other
+// files never had them inlined: they are kept out of line here too, as Lane's are.
+#define FROGGER_BENCH_OUT_OF_LINE __attribute__((noinline))
+
+class BranchyLane {
+public:
+    BranchyLane(const Lane& ln, const VehicleSlot* slots)
+    : type_(ln.Type()), dir_(ln.Dir()),
+      minSpeed_(ln.MinSpeed()), maxSpeed_(ln.MaxSpeed()), baseSpeed_(ln.BaseSpeed()),
+      slots_(slots, slots + ln.VehicleCount()) {
+        loopLenTiles_ = 0.f;
+        for (VehicleSlot& s : slots_) {
+            s.offset = loopLenTiles_;
+            loopLenTiles_ += static_cast<float>(s.lengthTiles + s.gapTiles);
+        }
+        if (loopLenTiles_ <= 0.f) loopLenTiles_ = 1.f;
+    }
+
+    float CurrentSpeed(float difficultyScale) const {
+        if (type_ == LaneType::Safe) return 0.f;
+        const float scaled = baseSpeed_ * std::max(1.f, difficultyScale);
+        return std::max(minSpeed_, std::min(scaled, maxSpeed_));
+    }
+
+    FROGGER_BENCH_OUT_OF_LINE void Update(float dtSeconds, float difficultyScale) {
+        if (type_ == LaneType::Safe) return;
+        lastAdvance_ = CurrentSpeed(difficultyScale) * dtSeconds;
+        phase_ = std::fmod(phase_ + lastAdvance_, loopLenTiles_);
+        if (phase_ < 0.f) phase_ += loopLenTiles_;
+    }
+
+    template <typename Fn>
+    void ForEachVisibleVehicle(int gridW, int screenRowY, Fn&& fn) const {
+        if (type_ == LaneType::Safe) return;
+        for (const VehicleSlot& s : slots_) {
+            float phase = std::fmod(phase_, loopLenTiles_);
+            if (phase < 0.f) phase += loopLenTiles_;
+            const float w = static_cast<float>(s.lengthTiles);
+            float x;
+            if (dir_ == Direction::Right) x = -w + (phase - s.offset);
+            else                          x = static_cast<float>(gridW) + (s.offset - phase);
+            if (x + w <= 0.f || x >= static_cast<float>(gridW)) continue;
+            fn(TileRect{ x, static_cast<float>(screenRowY), w, 1.0f });
+        }
+    }
+
+    FROGGER_BENCH_OUT_OF_LINE bool CollidesAtScreenRow(const TileRect& player, int gridW, int screenRowY) const {
+        if (type_ == LaneType::Safe) return false;
+        const float rowY = static_cast<float>(screenRowY);
+        if (!(player.y < rowY + 1.0f && player.y + player.h > rowY)) return false;
+
+        const float L  = loopLenTiles_;
+        const float p1 = phase_;
+        const float p0 = p1 - std::min(lastAdvance_, L);
+        float segLo[2], segHi[2];
+        int segs = 0;
+        if (p0 >= 0.f) {
+            segLo[segs] = p0;     segHi[segs] = p1; ++segs;
+        } else {
+            segLo[segs] = p0 + L; segHi[segs] = L;  ++segs;
+            segLo[segs] = 0.f;    segHi[segs] = p1; ++segs;
+        }
+        const float W = static_cast<float>(gridW);
+        for (const VehicleSlot& s : slots_) {
+            const float w = static_cast<float>(s.lengthTiles);
+            for (int k = 0; k < segs; ++k) {
+                float lo, hi;
+                if (dir_ == Direction::Right) {
+                    lo = -w + (segLo[k] - s.offset);
+                    hi =      (segHi[k] - s.offset);
+                } else {
+                    lo = W + (s.offset - segHi[k]);
+                    hi = W + (s.offset - segLo[k]) + w;
+                }
+                if (hi <= 0.f || lo >= W) continue;
+                if (player.x < hi && player.x + player.w > lo) return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    LaneType type_;
+    Direction dir_;
+    float minSpeed_, maxSpeed_, baseSpeed_;
+    std::vector<VehicleSlot> slots_;
+    float loopLenTiles_ = 0.f;
+    float phase_ = 0.f;
+    float lastAdvance_ = 0.f;
+};
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRounds = 5;
+
+// Best of kRounds rounds of 'reps' calls to each body, in ns per (rep * perRep) units.
+// Rounds alternate between the bodies, so clock or load drift on a shared machine hits
+// every variant alike instead of whichever happened to run first.
+template <size_t N>
+std::array<double, N> NsPerEach(int reps, size_t perRep, const std::array<std::function<void()>, N>& bodies) {
+    std::array<double, N> best{};
+    for (int round = 0; round < kRounds; ++round) {
+        for (size_t b = 0; b < N; ++b) {
+            const auto t0 = Clock::now();
+            for (int r = 0; r < reps; ++r) bodies[b]();
+            const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+            if (round == 0 || ns < best[b]) best[b] = ns;
+        }
+    }
+    for (double& ns : best) ns /= static_cast<double>(reps) * static_cast<double>(perRep);
+    return best;
+}
+
+volatile float gSink;
+
+void BenchWidth(int gridW) {
+    constexpr int kRows = 4096;
+    constexpr int kReps = 200;
+    constexpr float kDt = 1.0f / 60.0f;
+    constexpr float kScale = 1.3f;
+    const int screenH = 9;
+
+    Game game(gridW);
+    game.ResetWithSeed("1234567890", SDL_Color{0, 255, 0, 255}, gridW / 2);
+    const int perLane = game.VehiclesPerLane();
+    std::vector<VehicleSlot> slotBuf(static_cast<size_t>(kRows) * static_cast<size_t>(perLane));
+    std::vector<Lane> lanes;
+    std::vector<BranchyLane> ref;
+    std::vector<int> groups[2];   // loop rows by Direction
+    lanes.reserve(kRows);
+    ref.reserve(kRows);
+    for (int r = 0; r < kRows; ++r) {
+        VehicleSlot* slots = slotBuf.data() + static_cast<size_t>(r) * static_cast<size_t>(perLane);
+        lanes.push_back(game.GenerateLane(r, slots));
+        ref.emplace_back(lanes.back(), slots);
+        if (lanes.back().IsTraffic()) groups[static_cast<size_t>(lanes.back().Dir())].push_back(r);
+    }
+    const size_t n = lanes.size();
+
+    // Update
+    const std::array<double, 3> up = NsPerEach<3>(kReps, n, {
+        [&] { for (BranchyLane& l : ref) l.Update(kDt, kScale); },
+        [&] { for (Lane& l : lanes) if (l.IsTraffic()) l.Update(kDt, kScale); },
+        [&] { for (const std::vector<int>& g : groups) for (int r : g) lanes[static_cast<size_t>(r)].Update(kDt, kScale); },
+    });
+    // The lanes took two timed runs of updates; bring the reference to the same phases
+    for (int r = 0; r < kRounds * kReps; ++r) for (BranchyLane& l : ref) l.Update(kDt, kScale);
+
+    // Visible vehicles; the counts double as a check that all three see the same traffic
+    long countRef = 0, countDispatch = 0, countGrouped = 0;
+    float sum = 0.f;
+    const std::array<double, 3> draw = NsPerEach<3>(kReps, n, {
+        [&] {
+            for (size_t i = 0; i < n; ++i) {
+                ref[i].ForEachVisibleVehicle(gridW, static_cast<int>(i) % screenH, [&](const TileRect& t) { sum += t.x; ++countRef; });
+            }
+        },
+        [&] {
+            for (size_t i = 0; i < n; ++i) {
+                lanes[i].ForEachVisibleVehicle(gridW, static_cast<int>(i) % screenH, [&](const TileRect& t) { sum += t.x; ++countDispatch; });
+            }
+        },
+        [&] {
+            auto visit = [&](const TileRect& t) { sum += t.x; ++countGrouped; };
+            for (int r : groups[static_cast<size_t>(Direction::Left)]) {
+                lanes[static_cast<size_t>(r)].ForEachVisibleVehicleAs<Direction::Left>(gridW, r % screenH, visit);
+            }
+            for (int r : groups[static_cast<size_t>(Direction::Right)]) {
+                lanes[static_cast<size_t>(r)].ForEachVisibleVehicleAs<Direction::Right>(gridW, r % screenH, visit);
+            }
+        },
+    });
+
+    // Swept collision of a 1x1 frog at a few columns
+    const int probes = 8;
+    long hitsRef = 0, hitsLane = 0;
+    const std::array<double, 2> hit = NsPerEach<2>(kReps, n * probes, {
+        [&] {
+            for (size_t i = 0; i < n; ++i) {
+                for (int p = 0; p < probes; ++p) {
+                    const TileRect frog{ static_cast<float>(p * gridW / probes), 0.f, 1.f, 1.f };
+                    hitsRef += ref[i].CollidesAtScreenRow(frog, gridW, 0);
+                }
+            }
+        },
+        [&] {
+            for (size_t i = 0; i < n; ++i) {
+                for (int p = 0; p < probes; ++p) {
+                    const TileRect frog{ static_cast<float>(p * gridW / probes), 0.f, 1.f, 1.f };
+                    hitsLane += lanes[i].CollidesAtScreenRow(frog, gridW, 0);
+                }
+            }
+        },
+    });
+    gSink = sum;
+
+    std::printf("gridW %d: %zu rows (%zu loop lanes, %d vehicles each)\n",
+                gridW, n, groups[0].size() + groups[1].size(), perLane);
+    std::printf("  %-9s %10s %10s %10s %12s\n", "ns/row", "ref", "dispatch", "grouped", "speedup");
+    std::printf("  %-9s %10.2f %10.2f %10.2f %11.2fx\n", "update", up[0], up[1], up[2], up[0] / up[2]);
+    std::printf("  %-9s %10.2f %10.2f %10.2f %11.2fx\n", "visible", draw[0], draw[1], draw[2], draw[0] / draw[2]);
+    std::printf("  %-9s %10.2f %10.2f %10s %11.2fx\n", "collide", hit[0], hit[1], "-", hit[0] / hit[1]);
+    if (countRef != countDispatch || countRef != countGrouped || hitsRef != hitsLane) {
+        std::printf("  MISMATCH: visible %ld / %ld / %ld, hits %ld / %ld\n",
+                    countRef, countDispatch, countGrouped, hitsRef, hitsLane);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<int> widths;
+    for (int i = 1; i < argc; ++i) widths.push_back(std::max(15, std::atoi(argv[i])));
+    if (widths.empty()) widths = { 15, 60, 240 };
+    for (int w : widths) BenchWidth(w);
+    return 0;
+}
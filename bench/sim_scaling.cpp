@@ -0,0 +1,90 @@
+// frogger_bench_scaling: headless sweep of the sim worker pool over the player count.
+//
+//   frogger_bench_scaling [--seconds S] [--sim-threads W] [--sim-hz H] [--grid-w N]
+//                         [--stream-lanes] [--players LIST]
+//
+// For each N (default 1,2,4,8,16,32,48,64) it runs N bot-driven games on a SimPool
+// exactly as `frogger --players N --bots all` does, minus the window, and prints one
+// row of sim cost, worker load and tick lateness. "games/core" is the sim-side ceiling:
+// how many games one fully busy core could tick at that cost. Frame time is not covered (it needs a
+// GPU); read the Frames line of a real run for that.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bot_driver.h"
+#include "sim_pool.h"
+#include "thread_tuning.h"
+
+int main(int argc, char** argv) {
+    double seconds = 3.0;
+    int simThreads = 0;
+    int simHz = 60;
+    int gridW = 15;
+    bool streamLanes = false;
+    std::vector<int> counts = { 1, 2, 4, 8, 16, 32, 48, 64 };
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::max(0.5, std::atof(argv[++i]));
+        } else if (arg == "--sim-threads" && i + 1 < argc) {
+            simThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--sim-hz" && i + 1 < argc) {
+            simHz = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--grid-w" && i + 1 < argc) {
+            gridW = std::clamp(std::atoi(argv[++i]), 15, 960);
+        } else if (arg == "--stream-lanes") {
+            streamLanes = true;
+        } else if (arg == "--players" && i + 1 < argc) {
+            if (!thread_tuning::ParseCpuList(argv[++i], counts)) {
+                std::fprintf(stderr, "bad player list: %s\n", argv[i]);
+                return 2;
+            }
+        } else {
+            std::fprintf(stderr, "usage: frogger_bench_scaling [--seconds S] [--sim-threads W] [--sim-hz H] "
+                                 "[--grid-w N] [--stream-lanes] [--players LIST]\n");
+            return 2;
+        }
+    }
+
+    const std::string seed = "1234567890";
+    const int startX = gridW / 2;
+    const int hw = static_cast<int>(std::thread::hardware_concurrency());
+    std::printf("%d cores, %d Hz, grid %dx9%s, %.1f s per run, bots at 10 actions/s\n",
+                hw, simHz, gridW, streamLanes ? ", stream lanes" : "", seconds);
+    std::printf("%8s %8s %14s %10s %12s %12s %11s\n",
+                "players", "threads", "us/game-tick", "busy %", "worst tick", "late ticks", "games/core");
+
+    for (int players : counts) {
+        players = std::clamp(players, 1, 64);
+        std::vector<std::unique_ptr<PlayerSlot>> slots;
+        for (int i = 0; i < players; ++i) {
+            slots.push_back(std::make_unique<PlayerSlot>(gridW, 9, "P" + std::to_string(i + 1), SDL_Color{0, 255, 0, 255}));
+            slots.back()->game.SetStreamLanes(streamLanes);
+            slots.back()->game.ResetWithSeed(seed, slots.back()->color, startX);
+            slots.back()->bot = true;
+        }
+        // Same default as the game: one worker per core minus the event and render threads
+        const int threads = simThreads > 0 ? simThreads : std::min(players, std::max(1, hw - 2));
+        SimPool pool(slots, threads, simHz);
+        pool.SetBotRestart(seed, startX);
+        BotDriver bots(slots, std::min(10.0, static_cast<double>(simHz)), "random", seed);
+
+        pool.Start();
+        bots.Start();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        bots.Stop();
+        pool.Stop();
+
+        const SimPool::RunStats s = pool.Stats();
+        const double perCore = s.usPerGameTick > 0 ? 1e6 / (static_cast<double>(simHz) * s.usPerGameTick) : 0.0;
+        std::printf("%8d %8d %14.2f %10.2f %9.3f ms %6llu/%-5llu %11.0f\n", players, pool.Threads(), s.usPerGameTick,
+                    s.busyPct, s.worstTickMs, static_cast<unsigned long long>(s.lateTicks),
+                    static_cast<unsigned long long>(s.ticks), perCore);
+    }
+    return 0;
+}
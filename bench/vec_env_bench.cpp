@@ -0,0 +1,85 @@
+// frogger_bench_vecenv: VecEnv throughput in env steps per second.
+//
+//   frogger_bench_vecenv [--envs N] [--threads W] [--steps S] [--grid-w N] [--stream-lanes]
+//
+// Steps N envs with uniform random actions (drawn before the timed loop) and reports
+// env steps/s and episodes. Without --threads it sweeps 1, 2, 4, ... up to the core count.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "vec_env.h"
+
+static void Run(VecEnvConfig cfg, int steps) {
+    VecEnv env(cfg);
+    const size_t n = static_cast<size_t>(env.NumEnvs());
+    std::vector<uint8_t> obs(n * static_cast<size_t>(env.ObsSize())), dones(n);
+    std::vector<float> rewards(n);
+
+    // A few distinct action rows, cycled, so the timed loop only steps
+    constexpr int kActionRows = 64;
+    std::vector<EnvAction> actions(n * kActionRows);
+    uint64_t rng = 0x2545f4914f6cdd1dULL;
+    for (EnvAction& a : actions) {
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        a = static_cast<EnvAction>(rng % 5);
+    }
+
+    env.Reset(obs.data());
+    for (int s = 0; s < 100; ++s) {   // warm-up
+        env.Step(actions.data() + n * static_cast<size_t>(s % kActionRows), obs.data(), rewards.data(), dones.data());
+    }
+    const uint64_t episodes0 = env.Episodes();
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s) {
+        env.Step(actions.data() + n * static_cast<size_t>(s % kActionRows), obs.data(), rewards.data(), dones.data());
+    }
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const double envSteps = static_cast<double>(n) * static_cast<double>(steps);
+    std::printf("%6zu envs %3d threads: %8.2f M env steps/s (%6.1f ns per env step), %llu episodes\n",
+                n, env.Threads(), envSteps / sec / 1e6, sec * 1e9 / envSteps,
+                static_cast<unsigned long long>(env.Episodes() - episodes0));
+}
+
+int main(int argc, char** argv) {
+    VecEnvConfig cfg;
+    cfg.numEnvs = 4096;
+    cfg.seed = "1234567890";
+    cfg.maxEpisodeSteps = 3600;
+    int threads = 0;
+    int steps = 500;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--envs" && i + 1 < argc) {
+            cfg.numEnvs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--steps" && i + 1 < argc) {
+            steps = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--grid-w" && i + 1 < argc) {
+            cfg.gridW = std::atoi(argv[++i]);
+        } else if (arg == "--stream-lanes") {
+            cfg.streamLanes = true;
+        } else {
+            std::fprintf(stderr, "usage: frogger_bench_vecenv [--envs N] [--threads W] [--steps S] "
+                                 "[--grid-w N] [--stream-lanes]\n");
+            return 2;
+        }
+    }
+
+    if (threads > 0) {
+        cfg.threads = threads;
+        Run(cfg, steps);
+        return 0;
+    }
+    const int hw = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int w = 1; ; w *= 2) {
+        cfg.threads = std::min(w, hw);
+        Run(cfg, steps);
+        if (cfg.threads == hw) break;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "alloc_audit.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+namespace {
+thread_local uint64_t tAllocCount = 0;
+std::atomic<uint64_t> gAllocCount{0};
+}
+
+#ifdef FROGGER_ALLOC_AUDIT
+
+static void* countedAlloc(std::size_t n) {
+    ++tAllocCount;
+    gAllocCount.fetch_add(1, std::memory_order_relaxed);
+    if (n == 0) n = 1;
+    if (void* p = std::malloc(n)) return p;
+    throw std::bad_alloc();
+}
+
+static void* countedAlignedAlloc(std::size_t n, std::align_val_t al) {
+    ++tAllocCount;
+    gAllocCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t a = static_cast<std::size_t>(al);
+    if (a < sizeof(void*)) a = sizeof(void*);
+    std::size_t sz = (n + a - 1) / a * a;   // aligned_alloc wants a multiple of the alignment
+    if (sz == 0) sz = a;
+    if (void* p = std::aligned_alloc(a, sz)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t n)                                   { return countedAlloc(n); }
+void* operator new[](std::size_t n)                                 { return countedAlloc(n); }
+void* operator new(std::size_t n, std::align_val_t al)              { return countedAlignedAlloc(n, al); }
+void* operator new[](std::size_t n, std::align_val_t al)            { return countedAlignedAlloc(n, al); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept   { try { return countedAlloc(n); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { try { return countedAlloc(n); } catch (...) { return nullptr; } }
+
+void operator delete(void* p) noexcept                              { std::free(p); }
+void operator delete[](void* p) noexcept                            { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept                 { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept               { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept            { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept          { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept   { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+#endif // FROGGER_ALLOC_AUDIT
+
+namespace alloc_audit {
+
+uint64_t ThreadAllocCount() { return tAllocCount; }
+uint64_t ProcessAllocCount() { return gAllocCount.load(std::memory_order_relaxed); }
+
+TickAudit::TickAudit(std::string name, uint64_t warmupTicks)
+: name_(std::move(name)), warmupTicks_(warmupTicks) {}
+
+void TickAudit::EndTick(bool scrolled) {
+    const uint64_t n = ThreadAllocCount() - before_;
+    if (ticks_++ < warmupTicks_) return;
+
+    ++auditedTicks_;
+    if (scrolled) ++auditedScrolls_;
+    if (n == 0) return;
+
+    if (badTicks_ == 0) firstBadTick_ = ticks_ - 1;
+    ++badTicks_;
+    if (scrolled) ++badScrolls_;
+    allocs_ += n;
+}
+
+std::string TickAudit::Summary() const {
+    std::ostringstream os;
+    os << "alloc audit " << name_ << ": " << allocs_ << " allocations in "
+       << auditedTicks_ << " ticks / " << auditedScrolls_ << " scrolls after warm-up";
+    if (badTicks_ > 0) {
+        os << " (FAIL: " << badTicks_ << " ticks, " << badScrolls_
+           << " scrolls allocated; first at tick " << firstBadTick_ << ")";
+    }
+    return os.str();
+}
+
+} // namespace alloc_audit
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Heap-allocation audit for the simulation hot path.
+// Configure with -DFROGGER_ALLOC_AUDIT=ON to replace the global operator new with a
+// per-thread counting version; without it ThreadAllocCount() is always 0.
+// tests/alloc_test.cpp (ctest alloc_audit) always builds the counting version.
+namespace alloc_audit {
+
+// Number of operator new calls made by the calling thread so far
+uint64_t ThreadAllocCount();
+// ... and by every thread in the process (for work fanned out to other threads)
+uint64_t ProcessAllocCount();
+
+// Per sim thread bookkeeping: after 'warmupTicks' every tick (input + scroll + update
+// + snapshot publish) must make zero heap allocations.
+class TickAudit {
+public:
+    TickAudit(std::string name, uint64_t warmupTicks);
+
+    void BeginTick() { before_ = ThreadAllocCount(); }
+    void EndTick(bool scrolled);
+    // Instead of EndTick() for a tick that rebuilt a game on purpose (bot restart)
+    void SkipTick() { ++ticks_; }
+
+    // One-line summary, e.g. "alloc audit P1: 0 allocations in 3600 ticks / 4 scrolls"
+    std::string Summary() const;
+    bool Clean() const { return badTicks_ == 0; }
+
+private:
+    std::string name_;
+    uint64_t warmupTicks_;
+    uint64_t before_ = 0;
+    uint64_t ticks_ = 0;
+    uint64_t auditedTicks_ = 0;
+    uint64_t auditedScrolls_ = 0;
+    uint64_t badTicks_ = 0;
+    uint64_t badScrolls_ = 0;
+    uint64_t allocs_ = 0;
+    uint64_t firstBadTick_ = 0;
+};
+
+} // namespace alloc_audit
@@ -0,0 +1,70 @@
+#include "bot_driver.h"
+#include <algorithm>
+#include <chrono>
+#include "state_hash.h"
+
+bool BotDriver::ValidPolicy(const std::string& policy) {
+    if (policy == "random") return true;
+    if (policy.empty()) return false;
+    return std::all_of(policy.begin(), policy.end(), [](char c) {
+        return c == 'U' || c == 'D' || c == 'L' || c == 'R';
+    });
+}
+
+BotDriver::BotDriver(std::vector<std::unique_ptr<PlayerSlot>>& slots, double rateHz,
+                     std::string policy, const std::string& seed)
+: rateHz_(std::max(0.1, rateHz)),
+  script_(policy == "random" ? std::string() : std::move(policy)) {
+    uint64_t base = 0;
+    for (unsigned char c : seed) base = HashMix(base, c);
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (!slots[i]->bot) continue;
+        // Distinct, nonzero xorshift state per bot
+        bots_.push_back(Bot{ slots[i].get(), HashMix(base, i) | 1u });
+    }
+}
+
+void BotDriver::Start() {
+    if (bots_.empty() || thread_.joinable()) return;
+    stop_.store(false);
+    thread_ = std::thread(&BotDriver::loop_, this);
+}
+
+void BotDriver::Stop() {
+    stop_.store(true);
+    if (thread_.joinable()) thread_.join();
+}
+
+InputAction BotDriver::next_(Bot& b) {
+    if (!script_.empty()) {
+        const char c = script_[b.scriptPos];
+        b.scriptPos = (b.scriptPos + 1) % script_.size();
+        switch (c) {
+            case 'D': return InputAction::Down;
+            case 'L': return InputAction::Left;
+            case 'R': return InputAction::Right;
+            default:  return InputAction::Up;
+        }
+    }
+    b.rng ^= b.rng << 13;
+    b.rng ^= b.rng >> 7;
+    b.rng ^= b.rng << 17;
+    return static_cast<InputAction>(b.rng % 4);
+}
+
+void BotDriver::loop_() {
+    using clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / rateHz_));
+    auto next = clock::now();
+    while (!stop_.load()) {
+        for (Bot& b : bots_) {
+            b.slot->input.push(QueuedInput{ next_(b), InputTrace{} });
+        }
+        pushed_.fetch_add(bots_.size(), std::memory_order_relaxed);
+        next += period;
+        // After a stall, carry on from now rather than bursting to catch up
+        const auto now = clock::now();
+        if (next < now) next = now;
+        std::this_thread::sleep_until(next);
+    }
+}
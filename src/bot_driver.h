@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sim_pool.h"
+
+// Synthetic players for load and soak testing (--bots). One thread pushes actions into
+// the bot slots' input queues at a fixed rate, exactly like the keyboard does, so the
+// whole queue -> sim -> snapshot -> render path is exercised. Bots don't look at the
+// game: the policy is either uniform random or a fixed script of moves played in a loop.
+// Game-over restarts happen in the SimPool worker (PlayerSlot::bot). Bot inputs are not
+// latency-traced: they have no key event, and the histograms are for human key-to-photon.
+class BotDriver {
+public:
+    // policy: "random", or a script of U/D/L/R letters (e.g. "UUULUR")
+    static bool ValidPolicy(const std::string& policy);
+
+    BotDriver(std::vector<std::unique_ptr<PlayerSlot>>& slots, double rateHz,
+              std::string policy, const std::string& seed);
+    ~BotDriver() { Stop(); }
+
+    BotDriver(const BotDriver&) = delete;
+    BotDriver& operator=(const BotDriver&) = delete;
+
+    void Start();
+    void Stop();   // safe to call twice
+
+    int Bots() const { return static_cast<int>(bots_.size()); }
+    uint64_t Pushed() const { return pushed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Bot {
+        PlayerSlot* slot;
+        uint64_t rng;       // xorshift64 state, per bot
+        size_t scriptPos = 0;
+    };
+
+    void loop_();
+    InputAction next_(Bot& b);
+
+    std::vector<Bot> bots_;
+    double rateHz_;
+    std::string script_;   // empty = random
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> pushed_{0};
+    std::thread thread_;
+};
@@ -0,0 +1,96 @@
+#include "determinism.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+LockstepChecker::LockstepChecker(std::string name, std::size_t window)
+: name_(std::move(name)) {
+    ring_[0].resize(window);
+    ring_[1].resize(window);
+}
+
+void LockstepChecker::Reset() {
+    std::lock_guard<std::mutex> lock(m_);
+    for (auto& r : ring_) for (auto& d : r) d.tick = UINT64_MAX;
+    compared_ = 0;
+    diverged_.store(false, std::memory_order_relaxed);
+}
+
+void LockstepChecker::Submit(int side, const Game& game) {
+    // Tick() counts completed updates, so this digest belongs to tick Tick()-1
+    const uint64_t tick = game.Tick() - 1;
+    Digest mine;
+    mine.tick = tick;
+    for (int f = 0; f < kStateFieldCount; ++f) mine.fields[f] = game.FieldHash(static_cast<StateField>(f));
+
+    std::lock_guard<std::mutex> lock(m_);
+    const std::size_t slot = static_cast<std::size_t>(tick % ring_[0].size());
+    ring_[side][slot] = mine;
+
+    const Digest& other = ring_[1 - side][slot];
+    if (other.tick != tick) return;   // other side not there yet (or already overwritten)
+
+    ++compared_;
+    if (diverged_.load(std::memory_order_relaxed)) return;
+    for (int f = 0; f < kStateFieldCount; ++f) {
+        if (mine.fields[f] == other.fields[f]) continue;
+        divTick_  = tick;
+        divField_ = static_cast<StateField>(f);
+        divA_ = (side == 0) ? mine.fields[f] : other.fields[f];
+        divB_ = (side == 0) ? other.fields[f] : mine.fields[f];
+        diverged_.store(true, std::memory_order_relaxed);
+        std::cerr << "determinism " + name_ + ": diverged at tick " + std::to_string(tick)
+                   + " in field '" + StateFieldName(divField_) + "'\n";
+        return;
+    }
+}
+
+std::string LockstepChecker::Summary() const {
+    std::lock_guard<std::mutex> lock(m_);
+    std::ostringstream os;
+    os << "determinism " << name_ << ": " << compared_ << " ticks compared, ";
+    if (diverged_.load(std::memory_order_relaxed)) {
+        os << "FIRST DIVERGENCE at tick " << divTick_ << " field '" << StateFieldName(divField_)
+           << "' (" << std::hex << divA_ << " vs " << divB_ << std::dec << ")";
+    } else {
+        os << "in lockstep";
+    }
+    return os.str();
+}
+
+void ShadowLoop(Game& shadow,
+                TSQueue<ReplayStep>& steps,
+                LockstepChecker& checker,
+                std::atomic<bool>& stopFlag,
+                float dtSeconds)
+{
+    ReplayStep step;
+    for (;;) {
+        if (!steps.pop(step)) {
+            if (stopFlag.load()) break;   // primary is done and the queue is drained
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        if (!step.endOfTick) {
+            shadow.HandleInput(step.action);
+            continue;
+        }
+        shadow.Update(dtSeconds);
+        checker.Submit(1, shadow);
+    }
+}
+
+void ShadowSim::Start(const std::string& seed, SDL_Color color, int startX, float dtSeconds) {
+    game.ResetWithSeed(seed, color, startX);
+    steps.clear();
+    checker.Reset();
+    stop.store(false);
+    thread = std::thread(ShadowLoop, std::ref(game), std::ref(steps), std::ref(checker), std::ref(stop), dtSeconds);
+}
+
+std::string ShadowSim::Stop() {
+    stop.store(true);
+    if (thread.joinable()) thread.join();
+    return checker.Summary();
+}
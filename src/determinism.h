@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "game.h"
+#include "state_hash.h"
+#include "ts_queue.h"
+
+// One step of the primary sim's input stream, replayed verbatim by a shadow sim
+struct ReplayStep {
+    uint64_t tick;        // primary Game::Tick() when the step happened
+    bool endOfTick;       // true: run Update(); false: apply 'action'
+    InputAction action;
+};
+
+// Compares per-tick hash digests from two Game instances (side 0 and side 1) that
+// are fed identical inputs on different threads, and records the first divergence.
+class LockstepChecker {
+public:
+    // 'window': how many ticks one side may run ahead of the other and still be compared
+    explicit LockstepChecker(std::string name, std::size_t window = 4096);
+
+    // Called by each side's thread right after its Update()
+    void Submit(int side, const Game& game);
+
+    void Reset();
+    bool Diverged() const { return diverged_.load(std::memory_order_relaxed); }
+    std::string Summary() const;
+
+private:
+    struct Digest {
+        uint64_t tick = UINT64_MAX;   // UINT64_MAX = empty
+        std::array<uint64_t, kStateFieldCount> fields{};
+    };
+
+    std::string name_;
+    mutable std::mutex m_;
+    std::vector<Digest> ring_[2];
+    uint64_t compared_ = 0;
+
+    std::atomic<bool> diverged_{false};
+    uint64_t divTick_ = 0;
+    StateField divField_ = StateField::Frog;
+    uint64_t divA_ = 0, divB_ = 0;
+};
+
+// Shadow simulation thread body: replays 'steps' into 'shadow' and submits its digest
+// as side 1 after every tick. Drains whatever is queued once 'stopFlag' is set.
+void ShadowLoop(Game& shadow,
+                TSQueue<ReplayStep>& steps,
+                LockstepChecker& checker,
+                std::atomic<bool>& stopFlag,
+                float dtSeconds);
+
+// Shadow instance for --check-determinism: replays one player's inputs on its own
+// thread and must stay hash-for-hash in lockstep with the real game (side 0).
+struct ShadowSim {
+    ShadowSim(int gridW, int gridH, const std::string& name) : game(gridW, gridH), checker(name) {}
+
+    // Reset the shadow exactly like the primary and start replaying
+    void Start(const std::string& seed, SDL_Color color, int startX, float dtSeconds);
+    // Drain the replay queue, join, and return the checker summary
+    std::string Stop();
+
+    Game game;
+    TSQueue<ReplayStep> steps;
+    LockstepChecker checker;
+    std::atomic<bool> stop{false};
+    std::thread thread;
+};
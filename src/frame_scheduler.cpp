@@ -0,0 +1,70 @@
+#include "frame_scheduler.h"
+#include <algorithm>
+
+FrameScheduler::FrameScheduler(int refreshHz, bool vsync)
+: period_(std::chrono::duration_cast<clock::duration>(
+      std::chrono::duration<double>(1.0 / static_cast<double>(refreshHz > 0 ? refreshHz : 60)))),
+  slack_(vsync ? std::chrono::milliseconds(2) : clock::duration::zero()),
+  next_(clock::now()),
+  statsStart_(clock::now()) {}
+
+int FrameScheduler::WaitBudgetMs() const {
+    auto left = next_ - clock::now();
+    if (left <= clock::duration::zero()) return 0;
+    // Round up so we never wake just short of the deadline and spin
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(left);
+    if (ms < left) ms += std::chrono::milliseconds(1);
+    return static_cast<int>(ms.count());
+}
+
+void FrameScheduler::FrameDone(bool presented) {
+    const auto now = clock::now();
+    if (presented) {
+        ++presented_;
+        // With vsync, present just returned on a vblank: aim shortly before the next one.
+        // Without vsync this is plain period pacing from the present.
+        next_ = now + period_ - slack_;
+    } else {
+        ++skipped_;
+        next_ += period_;
+        // Never try to catch up on missed deadlines with a burst of frames
+        if (next_ < now) next_ = now + period_;
+    }
+}
+
+double FrameScheduler::AchievedFps() const {
+    double secs = std::chrono::duration<double>(clock::now() - statsStart_).count();
+    return secs > 0.0 ? static_cast<double>(presented_) / secs : 0.0;
+}
+
+double FrameScheduler::IdlePercent() const {
+    auto wall = clock::now() - statsStart_;
+    if (wall <= clock::duration::zero()) return 0.0;
+    double pct = 100.0 * std::chrono::duration<double>(idle_).count()
+                       / std::chrono::duration<double>(wall).count();
+    return std::min(100.0, pct);
+}
+
+void FrameScheduler::AddFrameWork(clock::duration d) {
+    work_ += d;
+    worstWork_ = std::max(worstWork_, d);
+    ++workFrames_;
+}
+
+double FrameScheduler::MeanFrameWorkMs() const {
+    if (workFrames_ == 0) return 0.0;
+    return std::chrono::duration<double, std::milli>(work_).count() / static_cast<double>(workFrames_);
+}
+
+double FrameScheduler::WorstFrameWorkMs() const {
+    return std::chrono::duration<double, std::milli>(worstWork_).count();
+}
+
+void FrameScheduler::ResetStats() {
+    statsStart_ = clock::now();
+    idle_ = clock::duration::zero();
+    presented_ = 0;
+    skipped_ = 0;
+    work_ = worstWork_ = clock::duration::zero();
+    workFrames_ = 0;
+}
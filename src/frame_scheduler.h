@@ -0,0 +1,51 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Paces the drawing thread: tells it how long it may block (in the event wait, or
+// asleep on a dedicated render thread) before the next present deadline, and tracks
+// achieved FPS and the share of wall time spent idle.
+class FrameScheduler {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // refreshHz: display refresh (0 -> 60). vsync: SDL_RenderPresent blocks on vblank.
+    FrameScheduler(int refreshHz, bool vsync);
+
+    // Milliseconds the caller may block waiting for events (0 once the deadline passed)
+    int WaitBudgetMs() const;
+    bool DeadlineReached() const { return clock::now() >= next_; }
+    clock::time_point Deadline() const { return next_; }
+
+    // Account time the drawing thread spent blocked (event wait or sleeping to the deadline)
+    void AddIdle(clock::duration d) { idle_ += d; }
+
+    // Account CPU time spent building and submitting one presented frame
+    void AddFrameWork(clock::duration d);
+
+    // Call once per deadline. 'presented' is false when the frame was skipped
+    // because nothing changed; the cadence is kept either way.
+    void FrameDone(bool presented);
+
+    // Stats since construction / last ResetStats()
+    double AchievedFps() const;
+    double IdlePercent() const;
+    uint64_t FramesPresented() const { return presented_; }
+    uint64_t FramesSkipped() const { return skipped_; }
+    double MeanFrameWorkMs() const;
+    double WorstFrameWorkMs() const;
+    void ResetStats();
+
+private:
+    clock::duration period_;
+    clock::duration slack_;          // render this long before vblank when vsync is on
+    clock::time_point next_;         // next present deadline
+
+    clock::time_point statsStart_;
+    clock::duration idle_{0};
+    uint64_t presented_ = 0;
+    uint64_t skipped_ = 0;
+    clock::duration work_{0};
+    clock::duration worstWork_{0};
+    uint64_t workFrames_ = 0;
+};
@@ -0,0 +1,88 @@
+#pragma once
+// Binary schema of a precompiled level pack (frogger_levelpack tool, --level-pack).
+//
+// A pack holds the generated lanes of the first `blocks` 7-row blocks for a fixed list of
+// curated seeds, so a match on one of them starts without running the lane generator.
+// Fixed layout, little-endian, no pointers; the game maps it read-only and points its
+// lanes straight at the slot table. Field offsets are pinned by the static_asserts at
+// the bottom: changing any of them requires bumping kVersion.
+//
+//   [Header]                        offset 0
+//   [SeedRecord] * seedCount        offset header.seedOffset, sorted by seed
+//   [LaneRecord] * seedCount * lanesPerSeed   offset header.laneOffset, world row 0 first
+//   [SlotRecord] * slotCount        offset header.slotOffset (vehicle patterns)
+//
+// Every section starts 64-byte aligned. A pack is only used by a game whose grid width,
+// height, stream-lane setting and lane generator version match the header; anything
+// past the packed rows is generated live, exactly as without a pack.
+#include <cstddef>
+#include <cstdint>
+
+namespace frogger_pack {
+
+constexpr uint32_t kMagic   = 0x4B504C46u;   // "FLPK" in memory order
+constexpr uint32_t kVersion = 1;
+constexpr int kRowsPerBlock = 7;             // two safe rows + five traffic rows
+
+struct Header {
+    uint32_t magic;              // kMagic
+    uint32_t version;            // kVersion
+    uint32_t generatorVersion;   // Game::kGeneratorVersion of the compiling build
+    uint32_t gridW;
+    uint32_t gridH;
+    uint32_t vehiclesPerLane;    // VehiclesPerLaneFor(gridW)
+    uint32_t streamLanes;        // 0/1: Game::SetStreamLanes the lanes were generated with
+    uint32_t blocks;             // packed blocks per seed
+    uint32_t lanesPerSeed;       // blocks * kRowsPerBlock
+    uint32_t seedCount;
+    uint32_t seedOffset;
+    uint32_t laneOffset;
+    uint32_t slotOffset;
+    uint32_t slotCount;
+    uint64_t fileSize;
+};
+
+// One curated seed plus what the compiler measured on its packed rows
+struct SeedRecord {
+    char seed[16];               // normalized 10-char seed, NUL-padded
+    uint64_t matchSeed;          // Game::MatchSeed()
+    uint32_t firstLane;          // lane table index of world row 0
+    uint32_t trafficLanes;       // packed rows with a vehicle loop
+    uint32_t streamLanes;        // packed rows with free-flowing vehicles
+    float difficulty;            // mean over loop rows of (vehicle coverage * base speed), tiles/s
+    float tightestWindowSec;     // min over loop rows of (widest gap / max speed): the shortest
+                                 // best-case opening to hop through
+    int32_t tightestRow;         // world row of that lane (-1 if none)
+    uint32_t reserved[4];
+};
+
+struct LaneRecord {
+    uint8_t kind;                // 0 = safe, 1 = vehicle loop, 2 = stream
+    uint8_t dir;                 // Direction: 0 = left, 1 = right
+    uint16_t slotCount;          // loop rows: vehicles in the pattern
+    uint32_t firstSlot;          // loop rows: slot table index of the first vehicle
+    float minSpeed;              // tiles/s
+    float maxSpeed;
+    float baseSpeed;
+    float loopLen;               // loop rows: pattern length in tiles
+    float maxLen;                // loop rows: longest vehicle in tiles
+    float spawnEverySec;         // stream rows
+};
+
+// Same layout as VehicleSlot, so lanes can use the table in place
+struct SlotRecord {
+    int32_t lengthTiles;
+    int32_t gapTiles;
+    float offset;                // start offset along the loop
+};
+
+enum LaneKind : uint8_t { kSafe = 0, kLoop = 1, kStream = 2 };
+
+static_assert(sizeof(Header) == 64, "schema");
+static_assert(offsetof(Header, fileSize) == 56, "schema");
+static_assert(sizeof(SeedRecord) == 64, "schema");
+static_assert(offsetof(SeedRecord, difficulty) == 36, "schema");
+static_assert(sizeof(LaneRecord) == 32, "schema");
+static_assert(sizeof(SlotRecord) == 12, "schema");
+
+} // namespace frogger_pack
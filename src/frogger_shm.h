@@ -0,0 +1,99 @@
+#pragma once
+// Binary schema of the live-state shared-memory segment (--shm-name).
+//
+// Fixed layout in host byte order (records are native structs copied in), no pointers;
+// any process on the same machine that maps the segment can read it without linking
+// the game. Field offsets are pinned by the
+// static_asserts at the bottom: changing any of them requires bumping kVersion.
+//
+//   [Header]                      offset 0, kHeaderSize bytes
+//   [PlayerRecord] * playerCount  offset header.playerOffset, header.playerStride apart
+//
+// The writer fills in the header and stores magic last (release); a reader loads magic
+// with acquire before trusting any other header field.
+//
+// Each PlayerRecord is a seqlock written by exactly one sim thread, once per tick:
+//   writer: seq = seq+1 (odd) ; fence ; write state ; seq = seq+1 (even, release)
+//   reader: s0 = seq (acquire) ; if odd retry ; copy state ; fence ; s1 = seq ;
+//           if s0 != s1 retry
+// Readers never block the writer and need no syscalls after mmap.
+//
+// Every run creates a new object under the name (the old one is unlinked, never
+// resized), so a reader's mapping stays valid after its writer exits. A writer that
+// exits cleanly sets session to kSessionClosed; reopen the name to follow the next run.
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace frogger_shm {
+
+constexpr uint32_t kMagic   = 0x474F5246u;   // "FROG" in memory order
+constexpr uint32_t kVersion = 2;            // 2: LaneRecord::kind tells stream lanes apart
+constexpr int kMaxLanes = 16;                // visible rows recorded per player (gridH <= 16)
+constexpr uint32_t kSessionClosed = 0xFFFFFFFFu;   // Header::session after the writer exited
+
+enum LaneKind : uint8_t { kSafe = 0, kLoop = 1, kStream = 2 };
+
+// One visible lane, bottom row first. Only loop lanes have a phase: a stream lane's
+// vehicles move independently and are not exported.
+struct LaneRecord {
+    int32_t worldRow;
+    uint8_t kind;        // LaneKind
+    uint8_t dir;         // 0 = left, 1 = right (Direction); 0 for safe lanes
+    uint16_t reserved;
+    float phase;         // loop lanes: [0, loopLen) tiles; 0 otherwise
+    float loopLen;       // loop lanes: pattern loop length in tiles; 1 otherwise
+};
+
+// Plain copy of one player's state; this is what readers get back
+struct PlayerState {
+    uint64_t tick;           // completed sim ticks since reset
+    uint64_t stateHash;      // Game::StateHash()
+    int32_t frogX;           // screen tiles, 0 = left
+    int32_t frogY;           // screen tiles, 0 = bottom row
+    int32_t score;
+    int32_t bottomRowWorld;  // world row of the bottom visible lane
+    int32_t lanesAdvanced;   // scroll count
+    uint8_t gameOver;        // 0/1
+    uint8_t laneCount;       // valid entries in lanes[]
+    uint16_t reserved;
+    LaneRecord lanes[kMaxLanes];
+};
+
+struct alignas(64) PlayerRecord {
+    std::atomic<uint32_t> seq;   // odd while the writer is mid-update
+    uint32_t reserved;
+    PlayerState state;
+};
+
+struct alignas(64) Header {
+    std::atomic<uint32_t> magic;     // kMagic once the rest of the header is written
+    uint32_t version;         // kVersion
+    uint32_t playerOffset;    // byte offset of PlayerRecord 0
+    uint32_t playerStride;    // sizeof(PlayerRecord)
+    uint32_t playerCount;
+    uint32_t gridW;
+    uint32_t gridH;
+    uint32_t simHz;
+    uint64_t writerPid;
+    std::atomic<uint32_t> session;   // bumped on every restart (all ticks go back to 0); kSessionClosed at exit
+    uint32_t reserved;
+    char seed[16];                   // normalized 10-char seed, NUL-padded
+};
+
+constexpr size_t kHeaderSize = sizeof(Header);
+
+inline size_t SegmentSize(uint32_t playerCount) {
+    return kHeaderSize + static_cast<size_t>(playerCount) * sizeof(PlayerRecord);
+}
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "seqlock word must be lock-free across processes");
+static_assert(sizeof(LaneRecord) == 16, "schema");
+static_assert(offsetof(PlayerState, lanes) == 40, "schema");
+static_assert(sizeof(PlayerState) == 40 + 16 * kMaxLanes, "schema");
+static_assert(offsetof(PlayerRecord, state) == 8, "schema");
+static_assert(sizeof(PlayerRecord) == 320, "schema");
+static_assert(offsetof(Header, session) == 40, "schema");
+static_assert(sizeof(Header) == 64, "schema");
+
+} // namespace frogger_shm
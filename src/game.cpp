@@ -1,22 +1,21 @@
 #include "game.h"
+#include "level_pack.h"
 #include <random>
 #include <algorithm>
 #include <cmath>
 
 // ---------- Seed helpers ----------
-std::string Game::NormalizeSeed10(std::string s) {
+void Game::NormalizeSeed10(const std::string& s, std::string& out) {
+    out.clear();
     if (s.empty()) {
         std::mt19937_64 rng{std::random_device{}()};
         std::uniform_int_distribution<int> d(0,9);
-        std::string out; out.reserve(10);
         for (int i=0;i<10;++i) out.push_back(char('0'+d(rng)));
-        return out;
+        return;
     }
-    if (s.size() >= 10) return s.substr(0,10);
-    std::string out; out.reserve(10);
+    if (s.size() >= 10) { out.assign(s, 0, 10); return; }
     while (out.size() < 10) out += s;
     out.resize(10);
-    return out;
 }
 
 uint64_t Game::SeedToU64(const std::string& norm10) {
@@ -29,39 +28,55 @@ uint64_t Game::SeedToU64(const std::string& norm10) {
 
 // ---------- Game ----------
 Game::Game(int gridW, int gridH)
-: gridW_(gridW), gridH_(gridH) {}
+: gridW_(gridW), gridH_(gridH),
+  laneArena_(static_cast<size_t>(gridH + kPregenTarget), Lane(0)),
+  lanes_(laneArena_.data(), gridH + kPregenTarget),
+  vehiclesPerLane_(VehiclesPerLaneFor(gridW)),
+  slotArena_(static_cast<size_t>(gridH + kPregenTarget) * static_cast<size_t>(vehiclesPerLane_)),
+  // Spawns are at least 0.9 s apart at >= 1.5 tiles/s, so a row never holds gridW+6 vehicles
+  streamPool_(gridH * (gridW + 6)) {
+    for (std::vector<int>& rows : loopRows_) rows.reserve(static_cast<size_t>(gridH));
+    streamRows_.reserve(static_cast<size_t>(gridH));
+}
 
 void Game::ResetWithSeed(const std::string& userSeed10, SDL_Color frogColor, int startX) {
-    normSeed10_ = NormalizeSeed10(userSeed10);
-    matchSeed_  = SeedToU64(normSeed10_);
+    NormalizeSeed10(userSeed10, normSeed10_);
+    streamLanes_ = streamLanesWanted_;
+    // A packed seed needs neither the seed hash nor the generator for its first blocks
+    packSeed_ = pack_ ? pack_->Find(normSeed10_, gridW_, gridH_, streamLanes_) : nullptr;
+    packLanes_ = packSeed_ ? pack_->Lanes(*packSeed_) : nullptr;
+    packRows_ = packSeed_ ? pack_->LanesPerSeed() : 0;
+    matchSeed_  = packSeed_ ? packSeed_->matchSeed : SeedToU64(normSeed10_);
 
     // Reset frog: start on lane 4 (0-based), x provided by caller
     frog_ = Frog(startX, /*startY*/ 0, frogColor);
     frog_.SetScore(0);
     gameOver_ = false;
+    streamPool_.Clear();
 
-    // Build initial lanes: world rows [0..gridH_-1], front=top (gridH_-1), back=bottom (0)
-    lanes_.clear();
-    pregen_.clear();
-    topRowWorld_ = 0;
-    bottomRowWorld_ = gridH_ - 1; // we will place so that back is bottom visible row 0 in screen coords
-
-    // We prefer world indices increasing upward. Let's define bottomRowWorld_ = 0 .. topRowWorld_ = 8 initially.
-    // So rebuild with bottom=0..top=gridH_-1
-    lanes_.clear();
+    // Build initial lanes: world rows [0..gridH_-1], lanes_[0] = bottom
+    lanes_.Clear();
     for (int wr = 0; wr < gridH_; ++wr) {
-        // We'll push_front so final order has front=top
-        lanes_.push_front(GenerateLane(wr));
+        PushGeneratedLane_(wr);
     }
-    topRowWorld_ = gridH_ - 1;     // world row at lanes_.front()
-    bottomRowWorld_ = 0;           // world row at lanes_.back()
+    topRowWorld_ = gridH_ - 1;     // world row at lanes_[gridH_-1]
+    bottomRowWorld_ = 0;           // world row at lanes_[0]
 
-    // Pre-generate next 5 lanes above current top
-    for (int i = 1; i <= 5; ++i) {
-        pregen_.push_back(GenerateLane(topRowWorld_ + i));
-    }
+    // Pre-generate the next blocks above current top; the sim thread keeps it topped up
+    EnsurePregen();
+    RebuildTrafficRows_();
+    warmStreamRows_(0, 1.0f);
 
     lanesAdvanced_ = 0;
+    prefetchHits_ = 0;
+    prefetchMisses_ = 0;
+    inputLockOnce_ = false;
+
+    // Lockstep hash starts from the match seed and the initial window
+    tick_ = 0;
+    fieldHash_.fill(matchSeed_);
+    hashField_(StateField::Frog, (static_cast<uint64_t>(frog_.GetX()) << 32) | static_cast<uint32_t>(frog_.GetY()));
+    hashVisibleLanes_(0);
 }
 
 // Difficulty multiplier based on progress (scroll count)
@@ -74,24 +89,45 @@ void Game::Update(float dtSeconds) {
     if (gameOver_) return;
 
     float scale = difficultyScaleFrom(lanesAdvanced_, difficultyAlpha_);
-    for (auto& ln : lanes_) {
-        ln.Update(dtSeconds, scale);
+    // Only traffic rows move; Safe rows cost nothing per tick
+    for (const std::vector<int>& rows : loopRows_) {
+        for (int y : rows) {
+            Lane& ln = lanes_[y];
+            ln.Update(dtSeconds, scale);
+            hashField_(StateField::Lanes, FloatBits(ln.Phase()));
+        }
+    }
+    for (int y : streamRows_) {
+        Lane& ln = lanes_[y];
+        const int due = ln.AdvanceSpawnClock(dtSeconds);
+        for (int k = 0; k < due; ++k) {
+            spawnStreamVehicle_(ln, ln.StreamSpawned() - static_cast<uint32_t>(due - k), 0.f, scale);
+        }
+        hashField_(StateField::Lanes, FloatBits(ln.Phase()));
+    }
+    if (streamLanes_) {
+        // One contiguous pass moves every pooled vehicle and recycles the ones that left
+        streamPool_.Update(dtSeconds, gridW_);
+        hashField_(StateField::Lanes, streamPool_.Fingerprint());
     }
 
-    // Collisions: frog is 1x1 tile rect
+    // Collisions: frog is 1x1 tile rect. Lanes test the vehicles' swept extent over
+    // this step, so the result does not depend on the tick rate.
     TileRect frogRect{ static_cast<float>(frog_.GetX()),
                        static_cast<float>(frog_.GetY()),
                        1.0f, 1.0f };
 
-   int i = 0;
-    for (const auto& ln : lanes_) {
-        int logicalY = gridH_ - 1 - i;  // convert topbottom index to logical bottomtop
-        if (ln.CollidesAtScreenRow(frogRect, gridW_, logicalY)) {
-            gameOver_ = true;
-            break;
-        }
-        ++i;
+    // Only the frog's own row can overlap it
+    const int frogY = frog_.GetY();
+    const Lane& frogLane = lanes_[frogY];
+    const bool hit = frogLane.IsStream()
+        ? streamPool_.CollidesSwept(frogLane.WorldRow(), frogRect.x, frogRect.w, dtSeconds, gridW_)
+        : frogLane.CollidesAtScreenRow(frogRect, gridW_, frogY);
+    if (hit) {
+        gameOver_ = true;
     }
+    hashField_(StateField::Status, (tick_ << 2) | (gameOver_ ? 2u : 0u) | (inputLockOnce_ ? 1u : 0u));
+    ++tick_;
     if (inputLockOnce_) inputLockOnce_ = false;
 }
 
@@ -132,6 +168,10 @@ bool Game::HandleInput(InputAction a) {
         // Optional: clamp X again (just in case)
         if (frog_.GetX() < 0) frog_.SetPosition(0, frog_.GetY());
         if (frog_.GetX() >= gridW_) frog_.SetPosition(gridW_-1, frog_.GetY());
+
+        hashField_(StateField::Frog, (tick_ << 3) | static_cast<uint64_t>(a));
+        hashField_(StateField::Frog, (static_cast<uint64_t>(frog_.GetX()) << 32) | static_cast<uint32_t>(frog_.GetY()));
+        hashField_(StateField::Frog, static_cast<uint32_t>(frog_.GetScore()));
     }
     return moved;
 }
@@ -149,23 +189,30 @@ void Game::ApplyScrollIfNeeded_(int prevY, int newY) {
 
     constexpr int kShift = 7;  // drop a whole block: 2 safe + 5 traffic
 
-    // 1) drop 7 lanes from the bottom
-    for (int i = 0; i < kShift; ++i) {
-        if (!lanes_.empty()) lanes_.pop_back();
-    }
+    // 1) drop 7 lanes from the bottom. The prefetched lanes behind the window
+    //    slide into view: an O(1) head move, nothing is copied or generated.
+    const int ready = std::min(kShift, lanes_.Size() - gridH_);
+    prefetchHits_ += ready;
+    lanes_.PopFront(kShift);
     bottomRowWorld_ += kShift;
+    topRowWorld_ = bottomRowWorld_ + gridH_ - 1;
 
-    // 2) add 7 new lanes at the top
-    for (int i = 0; i < kShift; ++i) {
-        const int nextWorld = topRowWorld_ + 1;  // always append the next world row
-        lanes_.push_front(GenerateLane(nextWorld));
-        topRowWorld_ = nextWorld;
+    // 2) only if the idle-time prefetch fell behind, generate the rest inline (a miss)
+    while (lanes_.Size() < gridH_) {
+        PushGeneratedLane_(bottomRowWorld_ + lanes_.Size());
+        ++prefetchMisses_;
     }
 
-    // 3) keep pregeneration healthy (optional if you don't use a pregen deque)
-    EnsurePregen(); // if you keep pregen, target >= 14 ahead inside it
+    // 3) the ring is refilled by PrefetchStep() in the sim thread's idle time
+    RebuildTrafficRows_();
+    if (streamLanes_) {
+        streamPool_.ReleaseRowsBelow(bottomRowWorld_);
+        warmStreamRows_(gridH_ - kShift, difficultyScaleFrom(lanesAdvanced_, difficultyAlpha_));
+    }
 
     lanesAdvanced_ += kShift;
+    hashField_(StateField::World, static_cast<uint64_t>(bottomRowWorld_));
+    hashVisibleLanes_(gridH_ - kShift);   // the rows that just came into view
 
     // 4) place frog on the SECOND safe lane (row 1).
     // Bottom two lanes are now the new block's safe pair (mod 0 and mod 1).
@@ -183,45 +230,98 @@ int Game::ClampDownTarget_(int desiredY) const {
     return std::max(0, std::min(gridH_-1, desiredY));
 }
 
-void Game::ForEachVehicle(const std::function<void(const TileRect&)>& fn) const {
-    int i = 0;
-    for (const auto& ln : lanes_) {
-        int logicalY = gridH_ - 1 - i;
-        ln.ForEachVisibleVehicle(gridW_, logicalY, fn);
-        ++i;
-    }
-}
-
 void Game::SnapshotLanes(std::vector<GameSnapshotLane>& out) const {
     out.clear();
     out.reserve(static_cast<size_t>(gridH_));
-    for (const auto& ln : lanes_) {
+    for (int y = gridH_ - 1; y >= 0; --y) {   // front = top
+        const Lane& ln = lanes_[y];
         out.push_back(GameSnapshotLane{ ln.Type(), ln.Dir(), ln.WorldRow() });
     }
 }
 
+void Game::FillSnapshot(ViewSnapshot& out) const {
+    out.gridW = gridW_;
+    out.gridH = gridH_;
+    SnapshotLanes(out.lanes);
+    out.vehicles.clear();
+    out.vehicles.reserve(static_cast<size_t>(gridH_) * static_cast<size_t>(vehiclesPerLane_) +
+                         static_cast<size_t>(streamPool_.Capacity()));  // no regrowth later
+    ForEachVehicle([&](const TileRect& r){ out.vehicles.push_back(r); });
+    out.frogX = frog_.GetX();
+    out.frogY = frog_.GetY();
+    out.frogColor = frog_.GetColor();
+    out.score = frog_.GetScore();
+    out.gameOver = gameOver_;
+}
+
+uint64_t Game::StateHash() const {
+    uint64_t h = tick_;
+    for (uint64_t f : fieldHash_) h = HashMix(h, f);
+    return h;
+}
+
+void Game::hashVisibleLanes_(int fromRow) {
+    for (int y = std::max(0, fromRow); y < gridH_; ++y) {
+        hashField_(StateField::World, lanes_[y].Fingerprint());
+    }
+}
+
+void Game::RebuildTrafficRows_() {
+    // capacity gridH_ reserved in the constructor
+    for (std::vector<int>& rows : loopRows_) rows.clear();
+    streamRows_.clear();
+    for (int y = 0; y < gridH_; ++y) {
+        const Lane& ln = lanes_[y];
+        if (ln.IsStream()) streamRows_.push_back(y);
+        else if (ln.IsTraffic()) loopRows_[static_cast<size_t>(ln.Dir())].push_back(y);
+    }
+}
+
 void Game::EnsurePregen() {
-    while (static_cast<int>(pregen_.size()) < 12) {
-        int nextWorldRow = topRowWorld_ + static_cast<int>(pregen_.size()) + 1;
-        pregen_.push_back(GenerateLane(nextWorldRow));
+    while (PrefetchStep()) {}
+}
+
+bool Game::PrefetchStep() {
+    if (lanes_.Full()) return false;
+    PushGeneratedLane_(bottomRowWorld_ + lanes_.Size());
+    return true;
+}
+
+void Game::PushGeneratedLane_(int worldRow) {
+    if (worldRow < packRows_) {
+        lanes_.PushBack(packedLane_(worldRow));
+        return;
     }
+    VehicleSlot* slots = slotArena_.data() +
+        static_cast<size_t>(lanes_.NextStorageIndex()) * static_cast<size_t>(vehiclesPerLane_);
+    lanes_.PushBack(GenerateLane(worldRow, slots));
 }
 
+// Same lane GenerateLane would build, straight from the mapped pack records
+Lane Game::packedLane_(int worldRow) const {
+    const frogger_pack::LaneRecord& r = packLanes_[worldRow];
+    const Direction dir = r.dir ? Direction::Right : Direction::Left;
+    switch (r.kind) {
+        case frogger_pack::kLoop:
+            return Lane(worldRow, dir, r.minSpeed, r.maxSpeed, r.baseSpeed,
+                        pack_->Slots() + r.firstSlot, r.slotCount, r.loopLen, r.maxLen);
+        case frogger_pack::kStream:
+            return Lane(worldRow, dir, r.minSpeed, r.maxSpeed, r.spawnEverySec);
+        default:
+            return Lane(worldRow);
+    }
+}
 
 // Deterministic per-row lane generator from matchSeed_ and worldRow.
 // - Guarantees: worldRow == 0 is always Safe (no instant death).
-// - Traffic rows: exactly 5 vehicles, lengths  {1,2,3}, gaps  [2..5],
+// - Traffic rows: vehiclesPerLane_ vehicles (5 at gridW=15), lengths  {1,2,3}, gaps  [2..5],
 //   min/max/base speeds (tiles/sec), and Left/Right direction.
-Lane Game::GenerateLane(int worldRow) {
+Lane Game::GenerateLane(int worldRow, VehicleSlot* slots) const {
     // SAFE ZONES: two safe rows per 7-row block.
     // Safe when worldRow % 7 == 0  OR  worldRow % 7 == 1
     int mod = worldRow % 7;
     if (mod == 0 || mod == 1) {
-        LaneConfig cfg;
-        cfg.type = LaneType::Safe;
-        cfg.dir  = Direction::Right; // ignored
-        for (auto& s : cfg.pattern) { s.lengthTiles = 1; s.gapTiles = 2; s.offset = 0.f; }
-        return Lane(worldRow, cfg);
+        return Lane(worldRow);
     }
 
     // Deterministic RNG from (matchSeed_, worldRow)
@@ -250,14 +350,52 @@ Lane Game::GenerateLane(int worldRow) {
     float maxS = std::min(4.5f, minS + nextF(0.5f, 2.0f));
     float base = nextF(minS, maxS);
 
-    // 5 vehicles, lengths 1/2/3 (biased to 2/3), gaps 2..5
-    std::array<int,5> lengths{};
-    std::array<int,5> gaps{};
-    for (int i=0;i<5;++i) {
+    // Stream lanes (opt-in): half the traffic rows, drawn after everything above so
+    // the classic layout is unchanged when they're off
+    if (streamLanes_ && (nextU() & 1u)) {
+        return Lane(worldRow, dir, minS, maxS, nextF(0.9f, 2.2f));
+    }
+
+    // vehiclesPerLane_ vehicles (5 at gridW=15), lengths 1/2/3 (biased to 2/3), gaps 2..5
+    for (int i = 0; i < vehiclesPerLane_; ++i) {
         int r = nextI(0, 99);
-        lengths[i] = (r < 20) ? 1 : (r < 60 ? 2 : 3);
-        gaps[i]    = nextI(2, 5);
+        slots[i].lengthTiles = (r < 20) ? 1 : (r < 60 ? 2 : 3);
+        slots[i].gapTiles    = nextI(2, 5);
     }
 
-    return Lane(worldRow, LaneType::Traffic, dir, minS, maxS, base, lengths, gaps);
+    return Lane(worldRow, LaneType::Traffic, dir, minS, maxS, base, slots, vehiclesPerLane_);
+}
+
+void Game::spawnStreamVehicle_(const Lane& ln, uint32_t key, float ageSeconds, float scale) {
+    // Per-vehicle randomness keyed by (match seed, world row, spawn index): deterministic
+    // no matter when or on which thread the lane is simulated
+    const uint64_t r = HashMix(HashMix(matchSeed_ ^ 0x5354524541ULL, static_cast<uint64_t>(ln.WorldRow())), key);
+    const float u = static_cast<float>(r >> 40) * (1.0f / 16777216.0f);
+    const int roll = static_cast<int>((r & 0xFFFFu) % 100u);
+    const int len = (roll < 20) ? 1 : (roll < 60 ? 2 : 3);
+    const float speed = std::min(ln.MaxSpeed(), (ln.MinSpeed() + (ln.MaxSpeed() - ln.MinSpeed()) * u) * scale);
+
+    const Direction dir = ln.Dir();
+    const float entryX = (dir == Direction::Right) ? -static_cast<float>(len) : static_cast<float>(gridW_);
+    const float x = Vehicle::Advance(entryX, speed, dir, ageSeconds);
+    if (Vehicle::IsOffScreenAt(x, len, dir, gridW_)) return;
+
+    // A full pool just skips the spawn (same outcome on every replay)
+    streamPool_.Spawn(Vehicle(x, ln.WorldRow(), len, speed, dir, SDL_Color{200, 40, 40, 255}));
+}
+
+void Game::warmStreamRows_(int fromRow, float scale) {
+    if (!streamLanes_) return;
+    for (int y = std::max(0, fromRow); y < gridH_; ++y) {
+        const Lane& ln = lanes_[y];
+        if (!ln.IsStream()) continue;
+        // Vehicles that "entered" 1, 2, ... spawn intervals ago, until even the fastest
+        // would have crossed the board; keys count down from the top so they never
+        // collide with live spawn keys
+        const float every = ln.SpawnEverySec();
+        const int count = static_cast<int>((static_cast<float>(gridW_) + 3.f) / (ln.MinSpeed() * every)) + 1;
+        for (int j = count; j >= 1; --j) {
+            spawnStreamVehicle_(ln, UINT32_MAX - static_cast<uint32_t>(j), every * static_cast<float>(j), scale);
+        }
+    }
 }
@@ -1,12 +1,18 @@
 #pragma once
-#include <deque>
 #include <array>
-#include <functional>
 #include <string>
+#include <vector>
 #include <SDL2/SDL.h>
 #include "frog.h"
 #include "lane.h"
+#include "frogger_levelpack.h"
+#include "lane_ring.h"
+#include "latency_trace.h"
+#include "state_hash.h"
 #include "vehicle.h" // Direction enum
+#include "vehicle_pool.h"
+
+class LevelPack;
 
 // Discrete one-tile inputs
 enum class InputAction { Up, Down, Left, Right };
@@ -17,11 +23,54 @@ struct GameSnapshotLane {
     int worldRow;
 };
 
+// Everything the renderer needs for one view. Filled by the sim thread that owns the
+// Game and handed to the UI thread through a TripleBuffer, so drawing never reads a
+// Game that is being updated.
+struct ViewSnapshot {
+    int gridW = 0;
+    int gridH = 0;
+    std::vector<GameSnapshotLane> lanes;   // front = top, like Game::Lanes()
+    std::vector<TileRect> vehicles;        // visible vehicles, screen tile coords
+    int frogX = 0;
+    int frogY = 0;
+    SDL_Color frogColor{0, 0, 0, 255};
+    int score = 0;
+    bool gameOver = false;
+    InputTrace input;                      // newest accepted traced input; set by the sim worker, not FillSnapshot
+};
+
 class Game {
 public:
     // gridH should be 9 for your design; gridW is how many columns you want to show.
     Game(int gridW, int gridH = 9);
 
+    // The lane ring points into this Game's own arena
+    Game(const Game&) = delete;
+    Game& operator=(const Game&) = delete;
+
+    // Optional: turn some traffic rows into stream lanes (free-moving pooled vehicles with
+    // their own speeds). Takes effect at the next ResetWithSeed; off by default.
+    void SetStreamLanes(bool enabled) { streamLanesWanted_ = enabled; }
+    bool StreamLanes() const { return streamLanes_; }
+    const VehiclePool& StreamPool() const { return streamPool_; }
+
+    // Optional precompiled level pack (not owned; must outlive the Game). A seed found in
+    // it starts from the packed lanes without running the generator; rows past the packed
+    // range are generated live. Takes effect at the next ResetWithSeed.
+    void SetLevelPack(const LevelPack* pack) { pack_ = pack; }
+    // The current match's pack record, or nullptr if it runs on live generation only
+    const frogger_pack::SeedRecord* PackedSeed() const { return packSeed_; }
+
+    // Bump whenever GenerateLane's output changes for any seed: level packs record the
+    // version they were compiled with and are refused by a different generator.
+    static constexpr uint32_t kGeneratorVersion = 1;
+
+    // Deterministic lane for world row 'worldRow' of the current match (seed and stream
+    // setting from the last reset), always from the generator. Traffic lanes write their
+    // pattern into 'slots' (VehiclesPerLane() entries). Also used by the pack compiler.
+    Lane GenerateLane(int worldRow, VehicleSlot* slots) const;
+    int VehiclesPerLane() const { return vehiclesPerLane_; }
+
     // Initialize (or reinitialize) with a user-provided seed ("" is allowed).
     // This normalizes to exactly 10 chars per your rule and builds lanes.
     void ResetWithSeed(const std::string& userSeed10, SDL_Color frogColor, int startX);
@@ -32,6 +81,8 @@ public:
     // Apply one-tile input and scoring. Enforces clamping & scroll trigger (4->5).
     // Returns true if the frog's position actually changed.
     bool HandleInput(InputAction a);
+    // True while HandleInput refuses moves (the rest of the tick after a scroll)
+    bool InputLocked() const { return inputLockOnce_; }
 
     // Game state
     bool IsGameOver() const { return gameOver_; }
@@ -44,30 +95,70 @@ public:
     int BottomRowWorld() const { return bottomRowWorld_; }
     int TopRowWorld() const { return topRowWorld_; }
 
-    // Lanes visible now (front = top, back = bottom). Exactly gridH_ lanes.
-    const std::deque<Lane>& Lanes() const { return lanes_; }
-
-    // Convenience: iterate visible vehicles tile rects for drawing
-    void ForEachVehicle(const std::function<void(const TileRect&)>& fn) const;
+    int LanesAdvanced() const { return lanesAdvanced_; }
+
+    // Lane currently drawn at screen row 'screenRow' (0 = bottom .. gridH-1 = top)
+    const Lane& LaneAtRow(int screenRow) const { return lanes_[screenRow]; }
+
+    // Convenience: iterate visible vehicles' tile rects for drawing
+    template <typename Fn>
+    void ForEachVehicle(Fn&& fn) const {
+        for (int y : loopRows_[static_cast<size_t>(Direction::Left)]) {
+            lanes_[y].ForEachVisibleVehicleAs<Direction::Left>(gridW_, y, fn);
+        }
+        for (int y : loopRows_[static_cast<size_t>(Direction::Right)]) {
+            lanes_[y].ForEachVisibleVehicleAs<Direction::Right>(gridW_, y, fn);
+        }
+        if (streamPool_.Live() == 0) return;
+        const float W = static_cast<float>(gridW_);
+        streamPool_.ForEachLive([&](float x, int row, int len, Direction) {
+            const int y = row - bottomRowWorld_;
+            const float w = static_cast<float>(len);
+            if (y < 0 || y >= gridH_ || x + w <= 0.f || x >= W) return;
+            fn(TileRect{ x, static_cast<float>(y), w, 1.0f });
+        });
+    }
 
     // Expose a compact lane snapshot for UI (types/directions/world rows)
     void SnapshotLanes(std::vector<GameSnapshotLane>& out) const;
 
+    // Copy the drawable state into 'out' (reuses its vector capacity)
+    void FillSnapshot(ViewSnapshot& out) const;
+
+    // Idle-time prefetch: generate one upcoming lane above the window if the ring has room.
+    // Returns false when the queue is already full (nothing to do).
+    bool PrefetchStep();
+
+    // Prefetch pipeline counters: lanes ready at scroll time vs generated inline on scroll
+    int PrefetchHits() const { return prefetchHits_; }
+    int PrefetchMisses() const { return prefetchMisses_; }
+
+    // ===== Lockstep state hash =====
+    // Running 64-bit hash of everything that affects play, maintained incrementally in
+    // ResetWithSeed / HandleInput / Update / the scroll. Two instances fed the same seed
+    // and the same inputs on the same ticks must report equal hashes at equal ticks.
+    uint64_t StateHash() const;
+    uint64_t FieldHash(StateField f) const { return fieldHash_[static_cast<size_t>(f)]; }
+    uint64_t Tick() const { return tick_; }   // completed Update() calls since reset
+
     // The normalized 10-char seed and the 64-bit match seed hash
     const std::string& NormalizedSeed() const { return normSeed10_; }
     uint64_t MatchSeed() const { return matchSeed_; }
 
 private:
     // ===== Deterministic lane generation =====
-    Lane GenerateLane(int worldRow);
-    void EnsurePregen(); // keep next 5 ready
-    // Normalize user seed to exactly 10 chars per your spec
-    static std::string NormalizeSeed10(std::string s);
+    // Generate world row 'worldRow' into the next ring position, using that position's slots
+    // (or, inside the packed range, point it at the level pack)
+    void PushGeneratedLane_(int worldRow);
+    void EnsurePregen(); // synchronously fill the prefetch part of the ring
+    // Normalize user seed to exactly 10 chars per your spec (writes into 'out')
+    static void NormalizeSeed10(const std::string& s, std::string& out);
     static uint64_t SeedToU64(const std::string& norm10);
 
     // ===== Camera/scroll rules =====
     // Called after a successful Up/Down move. Handles the 4->5 scroll.
     void ApplyScrollIfNeeded_(int prevY, int newY);
+    void RebuildTrafficRows_();
     // Clamp Down so player cant go below current bottom
     int ClampDownTarget_(int desiredY) const;
 
@@ -78,10 +169,32 @@ private:
 
     bool gameOver_ = false;
 
-    // lane ring buffer (size == gridH_)
-    std::deque<Lane> lanes_;
-    // pre-generated next lanes (keep 5 ready)
-    std::deque<Lane> pregen_;
+    // Lane storage is allocated once, in the constructor, and recycled in place.
+    // lanes_[0 .. gridH_-1] is the visible window (bottom -> top, world rows
+    // bottomRowWorld_..topRowWorld_); anything past that is prefetched lanes
+    // above the window, filled by PrefetchStep() and exposed by the scroll.
+    static constexpr int kPregenTarget = 14;   // two full blocks
+    std::vector<Lane> laneArena_;              // gridH_ + kPregenTarget lanes
+    LaneRing lanes_;
+    // Vehicle patterns: one contiguous segment of vehiclesPerLane_ slots per arena lane,
+    // reused by whichever lane occupies that ring position
+    int vehiclesPerLane_;
+    std::vector<VehicleSlot> slotArena_;
+
+    // Stream lanes (SetStreamLanes): vehicles of every visible stream row share one pool
+    bool streamLanesWanted_ = false;
+    bool streamLanes_ = false;       // latched at reset so a round never changes mode
+    VehiclePool streamPool_;
+    // Spawn stream vehicle 'key' of lane 'ln', moved on by 'ageSeconds' (0 = at the entry edge)
+    void spawnStreamVehicle_(const Lane& ln, uint32_t key, float ageSeconds, float scale);
+    // Give stream rows [fromRow, gridH_) the traffic they would have had if already running
+    void warmStreamRows_(int fromRow, float scale);
+    // Visible traffic rows grouped by lane kind, rebuilt on reset/scroll. Update and
+    // ForEachVehicle run one specialized kernel per group and never visit Safe rows.
+    std::array<std::vector<int>, 2> loopRows_;   // loop lanes, indexed by Direction
+    std::vector<int> streamRows_;
+    int prefetchHits_ = 0;
+    int prefetchMisses_ = 0;
 
     // world row indices for current visible window
     int topRowWorld_ = 0;          // world row of lanes_.front()
@@ -92,8 +205,24 @@ private:
     std::string normSeed10_;
     uint64_t matchSeed_ = 0;
 
+    // level pack: world rows [0, packRows_) come from packLanes_ (see SetLevelPack)
+    const LevelPack* pack_ = nullptr;
+    const frogger_pack::SeedRecord* packSeed_ = nullptr;
+    const frogger_pack::LaneRecord* packLanes_ = nullptr;
+    int packRows_ = 0;
+    Lane packedLane_(int worldRow) const;
+
     // difficulty ramp (applied to baseSpeed, then clamped to min/max)
     float difficultyAlpha_ = 0.02f; // tweakable growth per scroll
 
     bool inputLockOnce_ = false;
+
+    // lockstep hash state (see StateHash)
+    void hashField_(StateField f, uint64_t v) {
+        uint64_t& h = fieldHash_[static_cast<size_t>(f)];
+        h = HashMix(h, v);
+    }
+    void hashVisibleLanes_(int fromRow);   // mix config of rows [fromRow, gridH_) into World
+    std::array<uint64_t, kStateFieldCount> fieldHash_{};
+    uint64_t tick_ = 0;
 };
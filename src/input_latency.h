@@ -0,0 +1,47 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+// Event-thread blind time: stretches the thread spends away from the event queue
+// (handling events, drawing, blocked in present). SDL only timestamps an event when it
+// pumps it from the OS, so a key that arrives during such a stretch waits up to that long
+// unseen, and the event->push stage of LatencyTracer can't show it.
+class InputLatency {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // Bracket everything the event thread does between two event waits
+    void AwayFromQueue() {
+        away_ = clock::now();
+        if (!awayOnce_) { first_ = away_; awayOnce_ = true; }
+    }
+    void BackAtQueue() {
+        if (!awayOnce_) return;
+        const auto d = clock::now() - away_;
+        blindWorst_ = std::max(blindWorst_, d);
+        blindTotal_ += d;
+    }
+
+    std::string Summary() const {
+        const double wall = awayOnce_ ? ms_(clock::now() - first_) : 0.0;
+        std::ostringstream os;
+        os.setf(std::ios::fixed);
+        os.precision(2);
+        os << "Input  event thread away from the queue "
+           << (wall > 0 ? 100.0 * ms_(blindTotal_) / wall : 0.0) << "% of the time, worst stretch "
+           << ms_(blindWorst_) << " ms";
+        return os.str();
+    }
+
+private:
+    static double ms_(clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); }
+
+    bool awayOnce_ = false;
+    clock::time_point first_;
+    clock::time_point away_;
+    clock::duration blindWorst_{0};
+    clock::duration blindTotal_{0};
+};
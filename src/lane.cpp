@@ -1,122 +1,206 @@
 #include "lane.h"
 #include <algorithm>
+#include <cassert>
+#include "state_hash.h"
 
 static inline float clampf(float v, float lo, float hi) {
     return std::max(lo, std::min(v, hi));
 }
 
+Lane::Lane(int worldRowIndex)
+: worldRowIndex_(worldRowIndex) {}
+
 Lane::Lane(int worldRowIndex,
            LaneType type,
            Direction dir,
            float minSpeedTilesSec,
            float maxSpeedTilesSec,
            float baseSpeedTilesSec,
-           const std::array<int,5>& lengths,
-           const std::array<int,5>& gaps)
+           VehicleSlot* slots,
+           int slotCount)
 : worldRowIndex_(worldRowIndex),
-  type_(type),
-  dir_(dir),
-  minSpeed_(minSpeedTilesSec),
-  maxSpeed_(maxSpeedTilesSec),
-  baseSpeed_(baseSpeedTilesSec) {
+  kind_(kindOf_(type, dir)) {
+    if (kind_ == Kind::Safe) return;   // Safe lanes keep zero speed and no pattern
+
+    minSpeed_  = minSpeedTilesSec;
+    maxSpeed_  = maxSpeedTilesSec;
+    baseSpeed_ = baseSpeedTilesSec;
+    slotCount_ = slotCount;
+    buildPatternOffsets_(slots);
+}
 
-    for (std::size_t i = 0; i < slots_.size(); ++i) {
-        slots_[i].lengthTiles = lengths[i];
-        slots_[i].gapTiles    = gaps[i];
-        slots_[i].offset      = 0.f; // computed next
-    }
-    buildPatternOffsets_();
+Lane::Lane(int worldRowIndex, const LaneConfig& cfg, VehicleSlot* storage)
+: worldRowIndex_(worldRowIndex),
+  kind_(kindOf_(cfg.type, cfg.dir)) {
+    if (kind_ == Kind::Safe) return;
+
+    minSpeed_  = cfg.minSpeedTilesSec;
+    maxSpeed_  = cfg.maxSpeedTilesSec;
+    baseSpeed_ = cfg.baseSpeedTilesSec;
+    std::copy(cfg.pattern.begin(), cfg.pattern.end(), storage);
+    slotCount_ = static_cast<int>(cfg.pattern.size());
+    buildPatternOffsets_(storage);
 }
 
-Lane::Lane(int worldRowIndex, const LaneConfig& cfg)
+Lane::Lane(int worldRowIndex, Direction dir, float minSpeedTilesSec, float maxSpeedTilesSec,
+           float baseSpeedTilesSec, const VehicleSlot* slots, int slotCount,
+           float loopLenTiles, float maxLenTiles)
+: worldRowIndex_(worldRowIndex),
+  kind_(kindOf_(LaneType::Traffic, dir)),
+  slotCount_(slotCount),
+  slots_(slots),
+  maxLenTiles_(maxLenTiles),
+  minSpeed_(minSpeedTilesSec),
+  maxSpeed_(maxSpeedTilesSec),
+  baseSpeed_(baseSpeedTilesSec),
+  loopLenTiles_(loopLenTiles > 0.f ? loopLenTiles : 1.f) {}
+
+Lane::Lane(int worldRowIndex, Direction dir, float minSpeedTilesSec, float maxSpeedTilesSec, float spawnEverySec)
 : worldRowIndex_(worldRowIndex),
-  type_(cfg.type),
-  dir_(cfg.dir),
-  minSpeed_(cfg.minSpeedTilesSec),
-  maxSpeed_(cfg.maxSpeedTilesSec),
-  baseSpeed_(cfg.baseSpeedTilesSec),
-  slots_(cfg.pattern) {
-    buildPatternOffsets_();
+  kind_(dir == Direction::Left ? Kind::StreamLeft : Kind::StreamRight),
+  minSpeed_(minSpeedTilesSec),
+  maxSpeed_(maxSpeedTilesSec),
+  spawnEvery_(std::max(0.1f, spawnEverySec)) {}
+
+int Lane::AdvanceSpawnClock(float dtSeconds) {
+    phase_ += dtSeconds;
+    int due = 0;
+    while (phase_ >= spawnEvery_) {
+        phase_ -= spawnEvery_;
+        ++due;
+    }
+    streamSpawned_ += static_cast<uint32_t>(due);
+    return due;
 }
 
-void Lane::buildPatternOffsets_() {
+void Lane::buildPatternOffsets_(VehicleSlot* slots) {
+    slots_ = slots;
     loopLenTiles_ = 0.f;
-    for (std::size_t i = 0; i < slots_.size(); ++i) {
-        slots_[i].offset = loopLenTiles_;
-        loopLenTiles_ += static_cast<float>(slots_[i].lengthTiles + slots_[i].gapTiles);
+    maxLenTiles_ = 0.f;
+    for (int i = 0; i < slotCount_; ++i) {
+        VehicleSlot& s = slots[i];
+        s.offset = loopLenTiles_;
+        loopLenTiles_ += static_cast<float>(s.lengthTiles + s.gapTiles);
+        maxLenTiles_ = std::max(maxLenTiles_, static_cast<float>(s.lengthTiles));
     }
     if (loopLenTiles_ <= 0.f) loopLenTiles_ = 1.f; // guard
     phase_ = std::fmod(phase_, loopLenTiles_);
 }
 
+int Lane::firstSlotAtOrAfter_(float lo) const {
+    // Classic-width patterns are a handful of slots: a forward scan beats the search
+    if (slotCount_ <= kLinearScanSlots) {
+        int i = 0;
+        while (i < slotCount_ && slots_[i].offset < lo) ++i;
+        return i;
+    }
+    const VehicleSlot* begin = slots_;
+    const VehicleSlot* it = std::lower_bound(begin, begin + slotCount_, lo,
+        [](const VehicleSlot& s, float v) { return s.offset < v; });
+    return static_cast<int>(it - begin);
+}
+
 float Lane::CurrentSpeed(float difficultyScale) const {
-    if (type_ == LaneType::Safe) return 0.f;
+    // Loop and Safe lanes only: Safe lanes have min == max == base == 0, so they need no
+    // type test. Stream lanes have base 0 but min > 0 (each vehicle has its own speed).
+    assert(!IsStream());
     float scaled = baseSpeed_ * std::max(1.f, difficultyScale);
     return clampf(scaled, minSpeed_, maxSpeed_);
 }
 
 void Lane::Update(float dtSeconds, float difficultyScale) {
-    if (type_ == LaneType::Safe) return;
-    const float eff = CurrentSpeed(difficultyScale);
-    phase_ = std::fmod(phase_ + eff * dtSeconds, loopLenTiles_);
-    if (phase_ < 0.f) phase_ += loopLenTiles_;
+    // A stream lane's phase_ is its spawn clock (see AdvanceSpawnClock), not a loop phase
+    assert(!IsStream());
+    // Speeds are >= 0, so the wrapped phase stays in [0, L). A step is far shorter than
+    // the loop, so wrapping is one subtraction: for p in [L, 2L), p - L is exact and equal
+    // to fmod's result, so lockstep hashes and level packs see the same phases.
+    lastAdvance_ = CurrentSpeed(difficultyScale) * dtSeconds;
+    const float p = phase_ + lastAdvance_;
+    if (p < loopLenTiles_)            phase_ = p;
+    else if (p < 2.f * loopLenTiles_) phase_ = p - loopLenTiles_;
+    else                              phase_ = std::fmod(p, loopLenTiles_);
 }
 
-// Convert a slot's loop offset to the vehicle's LEFT x coordinate in tile units.
-// We arrange vehicles on an infinite line spaced by 'offset', then scroll with 'phase_'.
-// Right-moving lanes advance x as phase grows; left-moving recede.
-float Lane::slotX_(float slotOffset) const {
-    // Normalize slot position along the loop
-    float t = std::fmod(slotOffset + phase_, loopLenTiles_);
-    if (t < 0.f) t += loopLenTiles_;
-
-    // We map the loop directly onto world x:
-    // - For Right: x = -t  (vehicles start offscreen left and move right as phase increases)
-    // - For Left : x = t   (we'll subtract length when building rect)
-    return (dir_ == Direction::Right) ? -t : t;
+uint64_t Lane::Fingerprint() const {
+    uint64_t h = HashMix(static_cast<uint64_t>(kind_), static_cast<uint64_t>(worldRowIndex_));
+    h = HashMix(h, FloatBits(minSpeed_));
+    h = HashMix(h, FloatBits(maxSpeed_));
+    h = HashMix(h, FloatBits(baseSpeed_));
+    if (IsStream()) h = HashMix(h, FloatBits(spawnEvery_));
+    for (int i = 0; i < slotCount_; ++i) {
+        const VehicleSlot& s = slots_[i];
+        h = HashMix(h, (static_cast<uint64_t>(s.lengthTiles) << 32) | static_cast<uint32_t>(s.gapTiles));
+    }
+    return h;
 }
 
-void Lane::ForEachVisibleVehicle(int gridW, int screenRowY,
-                                 const std::function<void(const TileRect&)>& fn) const
-{
-    if (type_ == LaneType::Safe) return;
-
-    for (const auto& s : slots_) {
-        // phase along the repeating loop [0, L)
-        float L = loopLenTiles_;
-        float phase = std::fmod(phase_, L);
-        if (phase < 0.f) phase += L;
-
-        float w = static_cast<float>(s.lengthTiles);
-        float x;
-
-        if (dir_ == Direction::Right) {
-            // Start fully off-screen left, move right as phase increases
-            // x = -w + (phase - offset)
-            x = -w + (phase - s.offset);
-        } else {
-            // Start fully off-screen right, move left as phase increases
-            // x = gridW + (offset - phase)
-            x = static_cast<float>(gridW) + (s.offset - phase);
-        }
+bool Lane::CollidesAtScreenRow(const TileRect& player, int gridW, int screenRowY) const {
+    // Vertical overlap is the same for every vehicle in this row
+    const float rowY = static_cast<float>(screenRowY);
+    if (!(player.y < rowY + 1.0f && player.y + player.h > rowY)) return false;
+
+    switch (kind_) {
+        case Kind::Safe:         return false;
+        case Kind::TrafficLeft:  return collidesSwept_<Direction::Left>(player, gridW);
+        case Kind::TrafficRight: return collidesSwept_<Direction::Right>(player, gridW);
+        case Kind::StreamLeft:
+        case Kind::StreamRight:  return false;   // Game tests its VehiclePool
+    }
+    return false;
+}
 
-        // Cull against [0, gridW)
-        if (x + w <= 0.f || x >= static_cast<float>(gridW)) continue;
+template <Direction D>
+bool Lane::collidesSwept_(const TileRect& player, int gridW) const {
+    // Phase interval swept during the last step, ending at phase_.
+    // If it crossed the wrap point it splits into [p0+L, L) and [0, p1].
+    const float L  = loopLenTiles_;
+    const float p1 = phase_;
+    const float p0 = p1 - std::min(lastAdvance_, L);
+
+    float segLo[2], segHi[2];
+    int segs = 0;
+    if (p0 >= 0.f) {
+        segLo[segs] = p0;     segHi[segs] = p1; ++segs;
+    } else {
+        segLo[segs] = p0 + L; segHi[segs] = L;  ++segs;
+        segLo[segs] = 0.f;    segHi[segs] = p1; ++segs;
+    }
 
-        TileRect rect{ x, static_cast<float>(screenRowY), w, 1.0f };
-        fn(rect);
+    const float W = static_cast<float>(gridW);
+    // The swept extent must touch both the screen and the player, so intersect the two
+    // spans: a vehicle hits if its extent overlaps [x0, x1)
+    const float x0 = std::max(0.f, player.x);
+    const float x1 = std::min(W, player.x + player.w);
+    if (x0 >= x1) return false;
+
+    // Classic-width patterns are a handful of slots: test them all without branching,
+    // which beats both the offset window and an early exit on unpredictable hits
+    if (slotCount_ <= kLinearScanSlots) {
+        bool hit = false;
+        for (int k = 0; k < segs; ++k) {
+            for (int i = 0; i < slotCount_; ++i) {
+                const VehicleSlot& s = slots_[i];
+                const float w = static_cast<float>(s.lengthTiles);
+                hit |= (x0 < LaneKernel<D>::SweptHi(segLo[k], segHi[k], s.offset, w, W)) &
+                       (x1 > LaneKernel<D>::SweptLo(segLo[k], segHi[k], s.offset, w, W));
+            }
+        }
+        return hit;
     }
-}
 
-bool Lane::CollidesAtScreenRow(const TileRect& player, int gridW, int screenRowY) const {
-    if (type_ == LaneType::Safe) return false;
-
-    bool hit = false;
-    ForEachVisibleVehicle(gridW, screenRowY, [&](const TileRect& v){
-        bool overlapX = (player.x < v.x + v.w) && (player.x + player.w > v.x);
-        bool overlapY = (player.y < v.y + v.h) && (player.y + player.h > v.y);
-        if (overlapX && overlapY) hit = true;
-    });
-    return hit;
+    // Longer patterns: only visit the slots whose offsets can reach [x0, x1)
+    for (int k = 0; k < segs; ++k) {
+        const float offHi = LaneKernel<D>::OffsetHi(segHi[k], x0, x1, W) + kWindowSlack;
+        for (int i = firstSlotAtOrAfter_(LaneKernel<D>::OffsetLo(segLo[k], x0, x1, maxLenTiles_, W) - kWindowSlack);
+             i < slotCount_ && slots_[i].offset <= offHi; ++i) {
+            const VehicleSlot& s = slots_[i];
+            const float w = static_cast<float>(s.lengthTiles);
+            const float lo = LaneKernel<D>::SweptLo(segLo[k], segHi[k], s.offset, w, W);
+            const float hi = LaneKernel<D>::SweptHi(segLo[k], segHi[k], s.offset, w, W);
+            // Swept extent must also touch the screen [0, gridW)
+            if (hi <= 0.f || lo >= W) continue;
+            if (player.x < hi && player.x + player.w > lo) return true;
+        }
+    }
+    return false;
 }
-
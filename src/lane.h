@@ -1,8 +1,8 @@
 #pragma once
-#include <array>
-#include <functional>
 #include <cstddef>
+#include <cstdint>
 #include <cmath>
+#include <vector>
 #include "vehicle.h"  // for Direction
 
 // Visible vs traffic lanes
@@ -13,7 +13,16 @@ struct TileRect {
     float x, y, w, h;
 };
 
-// One of the five repeating vehicles on the loop
+// Traffic lanes loop at least this many vehicles; wider boards get proportionally more
+// (see VehiclesPerLaneFor) so the loop stays longer than the screen
+constexpr int kMinVehiclesPerLane = 5;
+
+inline int VehiclesPerLaneFor(int gridW) {
+    const int scaled = (kMinVehiclesPerLane * gridW + 14) / 15;   // 5 at the classic gridW=15
+    return scaled > kMinVehiclesPerLane ? scaled : kMinVehiclesPerLane;
+}
+
+// One of the repeating vehicles on the loop
 struct VehicleSlot {
     int   lengthTiles;  // 1, 2, or 3
     int   gapTiles;     // 2..5 (distance after this vehicle to next)
@@ -27,65 +36,221 @@ struct LaneConfig {
     float minSpeedTilesSec = 0.f;
     float maxSpeedTilesSec = 0.f;
     float baseSpeedTilesSec= 0.f;               // pre-ramp baseline
-    std::array<VehicleSlot, 5> pattern{};       // exactly 5 vehicles
+    std::vector<VehicleSlot> pattern;           // any number of vehicles (unused for Safe)
+};
+
+// Per-direction lane geometry, resolved at compile time so traffic kernels
+// don't test the direction per vehicle.
+template <Direction D> struct LaneKernel;
+
+template <> struct LaneKernel<Direction::Right> {
+    // Start fully off-screen left, move right as phase increases: x = -w + (phase - offset)
+    static constexpr float X(float phase, float offset, float w, float /*gridW*/) {
+        return -w + (phase - offset);
+    }
+    // Offsets of vehicles (length <= maxW) that can touch screen span [x0, x1) while
+    // phase runs over [a, b] lie in [OffsetLo, OffsetHi]; offsets are sorted, so it's a slice
+    static constexpr float OffsetLo(float a, float /*x0*/, float x1, float maxW, float /*gridW*/) {
+        return a - maxW - x1;
+    }
+    static constexpr float OffsetHi(float b, float x0, float /*x1*/, float /*gridW*/) {
+        return b - x0;
+    }
+    // Union of [x, x+w] while phase runs over [a, b]
+    static constexpr float SweptLo(float a, float /*b*/, float offset, float w, float /*gridW*/) {
+        return -w + (a - offset);
+    }
+    static constexpr float SweptHi(float /*a*/, float b, float offset, float /*w*/, float /*gridW*/) {
+        return b - offset;
+    }
+};
+
+template <> struct LaneKernel<Direction::Left> {
+    // Start fully off-screen right, move left as phase increases: x = gridW + (offset - phase)
+    static constexpr float X(float phase, float offset, float /*w*/, float gridW) {
+        return gridW + (offset - phase);
+    }
+    static constexpr float OffsetLo(float a, float x0, float /*x1*/, float maxW, float gridW) {
+        return a + x0 - gridW - maxW;
+    }
+    static constexpr float OffsetHi(float b, float /*x0*/, float x1, float gridW) {
+        return b + x1 - gridW;
+    }
+    static constexpr float SweptLo(float /*a*/, float b, float offset, float /*w*/, float gridW) {
+        return gridW + (offset - b);
+    }
+    static constexpr float SweptHi(float a, float /*b*/, float offset, float w, float gridW) {
+        return gridW + (offset - a) + w;
+    }
 };
 
+// A lane does not own its vehicle pattern: 'slots' points at a segment of its Game's
+// slot arena (one segment per lane-ring position), so patterns of any length sit
+// contiguously and recycling a lane never allocates. Copies share the segment.
 class Lane {
 public:
-    // Construct a lane on world row 'worldRowIndex' with the fixed 5-vehicle pattern.
-    // 'lengths' and 'gaps' are 5-element arrays; gaps should be in [2,5].
+    // Safe (grass) lane on world row 'worldRowIndex': no vehicles, no pattern, never moves.
+    explicit Lane(int worldRowIndex);
+
+    // Traffic lane over 'slotCount' slots at 'slots' whose lengthTiles/gapTiles are filled
+    // in (gaps should be in [2,5]); offsets are computed in place.
     Lane(int worldRowIndex,
          LaneType type,
          Direction dir,
          float minSpeedTilesSec,
          float maxSpeedTilesSec,
          float baseSpeedTilesSec,
-         const std::array<int,5>& lengths,
-         const std::array<int,5>& gaps);
+         VehicleSlot* slots,
+         int slotCount);
+
+    // Construct from a prebuilt LaneConfig; its pattern is copied into 'storage', which
+    // must hold cfg.pattern.size() slots (offsets will be normalized).
+    Lane(int worldRowIndex, const LaneConfig& cfg, VehicleSlot* storage);
+
+    // Traffic lane over a prebuilt, read-only pattern whose offsets, loop length and longest
+    // vehicle were computed when it was generated (a mapped level pack): nothing is copied
+    // or written, so 'slots' may point into read-only memory.
+    Lane(int worldRowIndex,
+         Direction dir,
+         float minSpeedTilesSec,
+         float maxSpeedTilesSec,
+         float baseSpeedTilesSec,
+         const VehicleSlot* slots,
+         int slotCount,
+         float loopLenTiles,
+         float maxLenTiles);
 
-    // Construct directly from a prebuilt LaneConfig (pattern offsets will be normalized).
-    explicit Lane(int worldRowIndex, const LaneConfig& cfg);
+    // Stream lane: no pattern and no phase loop. Vehicles are individual entities with
+    // their own speeds in [min, max], spawned at the entry edge every 'spawnEverySec'
+    // into the owning Game's VehiclePool. The Game moves, draws and collides them.
+    Lane(int worldRowIndex, Direction dir, float minSpeedTilesSec, float maxSpeedTilesSec, float spawnEverySec);
 
     // Advance the lane's phase by dt (seconds) using clamped speed * difficultyScale (>=1).
+    // Direction-free and branch-free; Safe lanes have zero speed and are skipped by Game.
+    // Not for stream lanes, whose phase is the spawn clock (asserted).
     void Update(float dtSeconds, float difficultyScale);
 
-    // Current clamped speed (tiles/sec)
+    // Current clamped speed (tiles/sec) of a loop lane; always 0 for Safe lanes.
+    // Meaningless for stream lanes (asserted), whose vehicles each have their own speed.
     float CurrentSpeed(float difficultyScale) const;
 
-    // screenRowY: the row index in [0..gridH-1] where this lane is currently drawn
-    void ForEachVisibleVehicle(int gridW, int screenRowY,
-                            const std::function<void(const TileRect&)>& fn) const;
+    // screenRowY: the row index in [0..gridH-1] where this lane is currently drawn.
+    // Template visitor so per-frame callers don't pay for a std::function.
+    template <typename Fn>
+    void ForEachVisibleVehicle(int gridW, int screenRowY, Fn&& fn) const;
+    // Same, for a loop traffic lane the caller already knows runs in direction D
+    // (callers that group lanes by kind skip the per-lane dispatch)
+    template <Direction D, typename Fn>
+    void ForEachVisibleVehicleAs(int gridW, int screenRowY, Fn&& fn) const {
+        forEachVisible_<D>(gridW, screenRowY, fn);
+    }
 
-    // 'player' is in screen tile coords; compare against this lane at 'screenRowY'
+    // 'player' is in screen tile coords; compare against this lane at 'screenRowY'.
+    // Swept test: each vehicle's extent over the whole last Update step [t, t+dt]
+    // is checked, so fast vehicles / large dt cannot tunnel through the player.
     bool CollidesAtScreenRow(const TileRect& player, int gridW, int screenRowY) const;
 
 
     // Accessors
-    LaneType Type() const { return type_; }
-    Direction Dir() const { return dir_; }
+    LaneType Type() const { return kind_ == Kind::Safe ? LaneType::Safe : LaneType::Traffic; }
+    Direction Dir() const {
+        return (kind_ == Kind::TrafficLeft || kind_ == Kind::StreamLeft) ? Direction::Left : Direction::Right;
+    }
+    bool IsTraffic() const { return kind_ != Kind::Safe; }
+    bool IsStream() const { return kind_ == Kind::StreamLeft || kind_ == Kind::StreamRight; }
     int WorldRow() const { return worldRowIndex_; }
     void SetWorldRow(int r) { worldRowIndex_ = r; }
 
     // Loop length in tiles (sum of all (length + gap))
     float LoopLenTiles() const { return loopLenTiles_; }
+    int VehicleCount() const { return slotCount_; }
+
+    // Current loop phase in [0, LoopLenTiles())
+    float Phase() const { return phase_; }
+
+    // Stream lanes: advance the spawn clock by dt and return how many vehicles are due.
+    // StreamSpawned() counts spawns since the lane was generated (keys per-vehicle randomness).
+    int AdvanceSpawnClock(float dtSeconds);
+    uint32_t StreamSpawned() const { return streamSpawned_; }
+    float SpawnEverySec() const { return spawnEvery_; }
+    float MinSpeed() const { return minSpeed_; }
+    float MaxSpeed() const { return maxSpeed_; }
+    float BaseSpeed() const { return baseSpeed_; }
+    float MaxVehicleLen() const { return maxLenTiles_; }
+
+    // Hash of the lane's generated configuration (kind, row, speeds, pattern); not the phase
+    uint64_t Fingerprint() const;
 
 private:
-    void buildPatternOffsets_(); // computes offsets & loop length from slots
+    // (type, direction) folded into one tag; fixed for the lane's lifetime,
+    // so public entry points switch on it once and run a specialized kernel.
+    enum class Kind : unsigned char { Safe, TrafficLeft, TrafficRight, StreamLeft, StreamRight };
+    static Kind kindOf_(LaneType type, Direction dir) {
+        if (type == LaneType::Safe) return Kind::Safe;
+        return dir == Direction::Left ? Kind::TrafficLeft : Kind::TrafficRight;
+    }
 
-    // Map a slot's loop offset -> tile x coordinate for current phase & direction
-    float slotX_(float slotOffset) const;
+    // Computes offsets (written into 'slots', which becomes slots_), loop length & longest vehicle
+    void buildPatternOffsets_(VehicleSlot* slots);
+    // First slot whose offset is >= lo (binary search over the sorted offsets)
+    int firstSlotAtOrAfter_(float lo) const;
+    // Offset windows are widened by this much so float rounding at the edges can't drop
+    // a vehicle; the exact per-vehicle test still decides
+    static constexpr float kWindowSlack = 1.f;
+    static constexpr int kLinearScanSlots = 8;
+
+    template <Direction D, typename Fn>
+    void forEachVisible_(int gridW, int screenRowY, Fn&& fn) const;
+    template <Direction D>
+    bool collidesSwept_(const TileRect& player, int gridW) const;
 
 private:
     int worldRowIndex_ = 0;
 
-    LaneType type_     = LaneType::Safe;
-    Direction dir_     = Direction::Right;
+    Kind kind_         = Kind::Safe;
+    int slotCount_     = 0;     // vehicles in slots_ (0 for Safe lanes)
+    const VehicleSlot* slots_ = nullptr;   // segment in the owning Game's slot arena (or a level pack), offsets ascending
+    float maxLenTiles_ = 0.f;   // longest vehicle; bounds the offset window of a query
 
     float minSpeed_    = 0.f;   // tiles/sec
     float maxSpeed_    = 0.f;   // tiles/sec
     float baseSpeed_   = 0.f;   // tiles/sec
 
-    std::array<VehicleSlot,5> slots_{};
-    float loopLenTiles_ = 0.f;  // £(length + gap)
+    float loopLenTiles_ = 1.f;  // sum of (length + gap); 1 for Safe lanes
     float phase_        = 0.f;  // 0..loopLenTiles, advances with Update()
+    float lastAdvance_  = 0.f;  // unwrapped phase delta of the last Update()
+
+    float spawnEvery_   = 0.f;  // stream lanes: seconds between spawns (phase_ is the clock)
+    uint32_t streamSpawned_ = 0;
 };
+
+template <typename Fn>
+void Lane::ForEachVisibleVehicle(int gridW, int screenRowY, Fn&& fn) const {
+    switch (kind_) {
+        case Kind::Safe:         return;
+        case Kind::TrafficLeft:  forEachVisible_<Direction::Left>(gridW, screenRowY, fn);  return;
+        case Kind::TrafficRight: forEachVisible_<Direction::Right>(gridW, screenRowY, fn); return;
+        case Kind::StreamLeft:
+        case Kind::StreamRight:  return;   // pooled vehicles are visited by Game
+    }
+}
+
+template <Direction D, typename Fn>
+void Lane::forEachVisible_(int gridW, int screenRowY, Fn&& fn) const {
+    const float W = static_cast<float>(gridW);
+    const float y = static_cast<float>(screenRowY);
+    // Only the slice of slots whose offsets put them on [0, gridW) right now
+    const float hi = LaneKernel<D>::OffsetHi(phase_, 0.f, W, W) + kWindowSlack;
+    for (int i = firstSlotAtOrAfter_(LaneKernel<D>::OffsetLo(phase_, 0.f, W, maxLenTiles_, W) - kWindowSlack);
+         i < slotCount_ && slots_[i].offset <= hi; ++i) {
+        const VehicleSlot& s = slots_[i];
+        const float w = static_cast<float>(s.lengthTiles);
+        const float x = LaneKernel<D>::X(phase_, s.offset, w, W);
+
+        // Cull against [0, gridW)
+        if (x + w <= 0.f || x >= W) continue;
+
+        TileRect rect{ x, y, w, 1.0f };
+        fn(rect);
+    }
+}
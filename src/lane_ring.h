@@ -0,0 +1,44 @@
+#pragma once
+#include <cassert>
+#include "lane.h"
+
+// Fixed-capacity ring of lanes over caller-owned storage (Game's lane arena).
+// Index 0 is the front. Push/pop overwrite lanes in place and never allocate.
+class LaneRing {
+public:
+    LaneRing() = default;
+    LaneRing(Lane* storage, int capacity) : storage_(storage), capacity_(capacity) {}
+
+    int Size() const { return size_; }
+    int Capacity() const { return capacity_; }
+    bool Full() const { return size_ == capacity_; }
+
+    Lane& operator[](int i)             { assert(i >= 0 && i < size_); return storage_[slot_(i)]; }
+    const Lane& operator[](int i) const { assert(i >= 0 && i < size_); return storage_[slot_(i)]; }
+
+    // Storage index the next PushBack writes to; lets the owner keep side storage per position
+    int NextStorageIndex() const { assert(size_ < capacity_); return slot_(size_); }
+
+    void PushBack(const Lane& ln) {
+        assert(size_ < capacity_);
+        storage_[slot_(size_)] = ln;
+        ++size_;
+    }
+
+    // Drop up to n lanes from the front: O(1), just moves the head
+    void PopFront(int n = 1) {
+        if (n > size_) n = size_;
+        head_ = slot_(n);
+        size_ -= n;
+    }
+
+    void Clear() { head_ = 0; size_ = 0; }
+
+private:
+    int slot_(int i) const { int s = head_ + i; return (s >= capacity_) ? s - capacity_ : s; }
+
+    Lane* storage_ = nullptr;
+    int capacity_  = 0;
+    int head_      = 0;
+    int size_      = 0;
+};
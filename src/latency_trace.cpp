@@ -0,0 +1,141 @@
+#include "latency_trace.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "game.h"
+
+static const char* const kStageNames[] = {
+    "event->push", "push->pop", "accept->draw", "draw->present", "event->present",
+};
+
+void LatencyHistogram::Add(int64_t ns) {
+    ns = std::max<int64_t>(ns, 0);
+    uint64_t us = static_cast<uint64_t>(ns) / 1000;
+    int k = 0;
+    while (us > 1 && k < kBuckets - 1) { us >>= 1; ++k; }
+    buckets_[static_cast<size_t>(k)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sumNs_.fetch_add(ns, std::memory_order_relaxed);
+    int64_t prev = maxNs_.load(std::memory_order_relaxed);
+    while (ns > prev && !maxNs_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+}
+
+double LatencyHistogram::MeanUs() const {
+    const uint64_t n = Count();
+    return n ? static_cast<double>(sumNs_.load(std::memory_order_relaxed)) / 1000.0 / static_cast<double>(n) : 0.0;
+}
+
+uint64_t LatencyHistogram::PercentileUs(double p) const {
+    const uint64_t n = Count();
+    if (n == 0) return 0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p * static_cast<double>(n) + 0.5));
+    uint64_t seen = 0;
+    for (int k = 0; k < kBuckets; ++k) {
+        seen += Bucket(k);
+        if (seen >= rank) return uint64_t{2} << k;
+    }
+    return uint64_t{2} << (kBuckets - 1);
+}
+
+LatencyTracer::LatencyTracer(int players)
+: shownApplied_(static_cast<size_t>(players), 0) {
+    inFrame_.reserve(static_cast<size_t>(players));
+}
+
+InputTrace LatencyTracer::Begin(uint32_t sdlTimestampMs) {
+    // SDL timestamps are SDL_GetTicks() milliseconds; map the event's age onto our clock
+    const int64_t now = NowNs();
+    const uint32_t ageMs = SDL_GetTicks() - sdlTimestampMs;
+    InputTrace t;
+    t.id = nextId_.fetch_add(1, std::memory_order_relaxed);
+    t.eventNs = now - static_cast<int64_t>(ageMs) * 1'000'000;
+    t.stageNs = now;
+    record_(LatencyStage::EventToPush, now - t.eventNs);
+    return t;
+}
+
+void LatencyTracer::Handled(const InputTrace& trace, bool locked, bool moved, InputTrace& newest) {
+    const int64_t now = NowNs();
+    record_(LatencyStage::PushToPop, now - trace.stageNs);
+    if (locked) {
+        rejectedLocked_.fetch_add(1, std::memory_order_relaxed);
+    } else if (!moved) {
+        rejectedNoMove_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        const uint32_t applied = newest.applied + 1;
+        newest = trace;
+        newest.applied = applied;
+        newest.stageNs = now;
+    }
+}
+
+void LatencyTracer::FrameBuilt(const std::vector<const ViewSnapshot*>& views) {
+    const int64_t now = NowNs();
+    inFrame_.clear();
+    for (size_t i = 0; i < views.size() && i < shownApplied_.size(); ++i) {
+        const InputTrace& t = views[i]->input;
+        uint32_t& shown = shownApplied_[i];
+        if (t.applied < shown) shown = 0;   // new round
+        if (t.id == 0 || t.applied == shown) continue;
+        superseded_ += t.applied - shown - 1;
+        shown = t.applied;
+        record_(LatencyStage::AcceptToDraw, now - t.stageNs);
+        inFrame_.push_back(t);
+    }
+    builtNs_ = now;
+}
+
+void LatencyTracer::FramePresented() {
+    if (inFrame_.empty()) return;
+    const int64_t now = NowNs();
+    for (const InputTrace& t : inFrame_) {
+        record_(LatencyStage::DrawToPresent, now - builtNs_);
+        record_(LatencyStage::EventToPresent, now - t.eventNs);
+    }
+    inFrame_.clear();
+}
+
+std::string LatencyTracer::LiveLine() const {
+    std::ostringstream os;
+    os << "Latency";
+    for (size_t s = 0; s < stages_.size(); ++s) {
+        const LatencyHistogram& h = stages_[s];
+        os << "  " << kStageNames[s] << " " << h.PercentileUs(0.5) << "/" << h.PercentileUs(0.99) << "us";
+    }
+    os << "  (p50/p99 bucket edges, " << Stage(LatencyStage::EventToPresent).Count() << " presented)";
+    return os.str();
+}
+
+std::string LatencyTracer::Dump() const {
+    std::ostringstream os;
+    os.setf(std::ios::fixed);
+    os.precision(1);
+    const uint64_t traced = nextId_.load(std::memory_order_relaxed) - 1;
+    os << "Latency  " << traced << " keys traced; "
+       << Stage(LatencyStage::EventToPresent).Count() << " presented, "
+       << traced - Stage(LatencyStage::PushToPop).Count() << " never handled (game over, restart, exit), "
+       << rejectedLocked_.load(std::memory_order_relaxed) << " rejected by the input lock, "
+       << rejectedNoMove_.load(std::memory_order_relaxed) << " went nowhere (board edge), "
+       << superseded_ << " superseded before a frame showed them";
+    for (size_t s = 0; s < stages_.size(); ++s) {
+        const LatencyHistogram& h = stages_[s];
+        os << "\n  " << std::left << std::setw(15) << kStageNames[s] << std::right
+           << " n=" << h.Count() << " mean " << h.MeanUs() << " us, p50 <" << h.PercentileUs(0.5)
+           << " us, p99 <" << h.PercentileUs(0.99) << " us, max " << h.MaxUs() << " us";
+        uint64_t most = 0;
+        int lo = LatencyHistogram::kBuckets, hi = -1;
+        for (int k = 0; k < LatencyHistogram::kBuckets; ++k) {
+            if (h.Bucket(k) == 0) continue;
+            most = std::max(most, h.Bucket(k));
+            lo = std::min(lo, k);
+            hi = k;
+        }
+        for (int k = lo; k <= hi; ++k) {
+            const uint64_t n = h.Bucket(k);
+            os << "\n    " << std::setw(9) << (k == 0 ? uint64_t{0} : uint64_t{1} << k) << " us  "
+               << std::setw(7) << n << " " << std::string(static_cast<size_t>(n * 40 / most), '#');
+        }
+    }
+    return os.str();
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ViewSnapshot;
+
+// Rides along with one key press from the event thread to the present that shows it
+struct InputTrace {
+    uint32_t id = 0;        // 0 = untraced (remote inputs, replays)
+    uint32_t applied = 0;   // in snapshots: traced inputs this player had accepted since reset
+    int64_t eventNs = 0;    // when the key went down (from the SDL timestamp), LatencyTracer::NowNs() clock
+    int64_t stageNs = 0;    // when it passed its latest stage (queued, then accepted)
+};
+
+// Input path stages, in order
+enum class LatencyStage {
+    EventToPush,      // SDL event timestamp -> pushed to the player's input queue (event thread)
+    PushToPop,        // waiting in the queue for the next sim tick
+    AcceptToDraw,     // Game::HandleInput accepted it -> first frame drawn with it
+    DrawToPresent,    // that frame's batch built -> SDL_RenderPresent returned
+    EventToPresent,   // end to end
+    Count
+};
+
+// Log2 latency histogram: bucket k holds [2^k, 2^(k+1)) microseconds (bucket 0 also
+// holds everything under 1 us). Add() is lock-free and may be called from any thread.
+class LatencyHistogram {
+public:
+    static constexpr int kBuckets = 32;
+
+    void Add(int64_t ns);
+    uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+    double MeanUs() const;
+    double MaxUs() const { return static_cast<double>(maxNs_.load(std::memory_order_relaxed)) / 1000.0; }
+    // Upper edge of the bucket holding the p-th percentile (p in [0, 1]), in microseconds
+    uint64_t PercentileUs(double p) const;
+    uint64_t Bucket(int k) const { return buckets_[static_cast<size_t>(k)].load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<int64_t> sumNs_{0};
+    std::atomic<int64_t> maxNs_{0};
+};
+
+// Input-to-photon tracing. The event thread starts a trace per key press and queues it
+// with the action; the sim worker stamps acceptance and carries the newest accepted trace
+// in every snapshot it publishes; the render thread closes it when the first frame showing
+// it has been presented. Every stage lands in its own histogram.
+class LatencyTracer {
+public:
+    explicit LatencyTracer(int players);
+
+    static int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Event thread: a key press (SDL timestamp, ms) about to be pushed
+    InputTrace Begin(uint32_t sdlTimestampMs);
+
+    // Sim worker: a traced input was popped and handed to Game::HandleInput. 'locked' is
+    // Game::InputLocked() before the call, 'moved' its result. An input that moved the frog
+    // becomes 'newest', the player's latest accepted trace carried in its snapshots.
+    void Handled(const InputTrace& trace, bool locked, bool moved, InputTrace& newest);
+
+    // Render side (one thread): after the frame's batch is built from 'views', and after
+    // its present returned. A restart is detected from the 'applied' count going back.
+    void FrameBuilt(const std::vector<const ViewSnapshot*>& views);
+    void FramePresented();
+
+    const LatencyHistogram& Stage(LatencyStage s) const { return stages_[static_cast<size_t>(s)]; }
+
+    std::string LiveLine() const;   // one line, p50 / p99 per stage
+    std::string Dump() const;       // every stage with its histogram
+
+private:
+    void record_(LatencyStage s, int64_t ns) { stages_[static_cast<size_t>(s)].Add(ns); }
+
+    std::array<LatencyHistogram, static_cast<size_t>(LatencyStage::Count)> stages_;
+    std::atomic<uint32_t> nextId_{1};
+    std::atomic<uint64_t> rejectedLocked_{0};   // refused by the one-tick input lock
+    std::atomic<uint64_t> rejectedNoMove_{0};   // not locked, but the move went nowhere (board edge)
+    uint64_t superseded_ = 0;                   // replaced by a newer input before any frame showed it
+
+    // render side
+    std::vector<uint32_t> shownApplied_;        // per player, 'applied' of the newest drawn trace
+    std::vector<InputTrace> inFrame_;           // traces first drawn in the frame being presented
+    int64_t builtNs_ = 0;
+};
@@ -0,0 +1,258 @@
+#include "level_pack.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "game.h"
+
+using namespace frogger_pack;
+
+static_assert(sizeof(VehicleSlot) == sizeof(SlotRecord) &&
+              offsetof(VehicleSlot, lengthTiles) == offsetof(SlotRecord, lengthTiles) &&
+              offsetof(VehicleSlot, gapTiles) == offsetof(SlotRecord, gapTiles) &&
+              offsetof(VehicleSlot, offset) == offsetof(SlotRecord, offset),
+              "the slot table is used in place as VehicleSlot");
+
+static int CompareSeed(const char* a, const char* b) { return std::strncmp(a, b, sizeof(SeedRecord::seed)); }
+
+bool LevelPack::Open(const std::string& path, std::string& error) {
+    Close();
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    struct stat st{};
+    void* mem = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header)) {
+        size_ = static_cast<size_t>(st.st_size);
+        mem = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mem == MAP_FAILED) {
+        error = "not a level pack (too small or unreadable)";
+        size_ = 0;
+        return false;
+    }
+
+    const char* base = static_cast<const char*>(mem);
+    const Header* h = static_cast<const Header*>(mem);
+    auto fits = [&](uint64_t offset, uint64_t count, size_t each) {
+        return offset % 64 == 0 && offset + count * each <= size_;
+    };
+    const uint64_t laneCount = static_cast<uint64_t>(h->seedCount) * h->lanesPerSeed;
+    if (h->magic != kMagic || h->version != kVersion) {
+        error = "not a level pack, or an unsupported version";
+    } else if (h->generatorVersion != Game::kGeneratorVersion) {
+        error = "compiled by lane generator v" + std::to_string(h->generatorVersion) +
+                ", this build has v" + std::to_string(Game::kGeneratorVersion);
+    } else if (h->fileSize != size_ || h->lanesPerSeed != h->blocks * kRowsPerBlock ||
+               !fits(h->seedOffset, h->seedCount, sizeof(SeedRecord)) ||
+               !fits(h->laneOffset, laneCount, sizeof(LaneRecord)) ||
+               !fits(h->slotOffset, h->slotCount, sizeof(SlotRecord))) {
+        error = "truncated or corrupt level pack";
+    } else {
+        error.clear();
+        const SeedRecord* seeds = reinterpret_cast<const SeedRecord*>(base + h->seedOffset);
+        const LaneRecord* lanes = reinterpret_cast<const LaneRecord*>(base + h->laneOffset);
+        for (uint32_t i = 0; i < h->seedCount && error.empty(); ++i) {
+            if (static_cast<uint64_t>(seeds[i].firstLane) + h->lanesPerSeed > laneCount ||
+                (i > 0 && CompareSeed(seeds[i - 1].seed, seeds[i].seed) >= 0)) {
+                error = "corrupt seed table";
+            }
+        }
+        for (uint64_t i = 0; i < laneCount && error.empty(); ++i) {
+            const LaneRecord& r = lanes[i];
+            if (r.kind > kStream || r.dir > 1 ||
+                (r.kind == kLoop && (r.slotCount == 0 || static_cast<uint64_t>(r.firstSlot) + r.slotCount > h->slotCount))) {
+                error = "corrupt lane table";
+            }
+        }
+    }
+    if (!error.empty()) {
+        munmap(mem, size_);
+        size_ = 0;
+        return false;
+    }
+
+    header_ = h;
+    seeds_ = reinterpret_cast<const SeedRecord*>(base + h->seedOffset);
+    lanes_ = reinterpret_cast<const LaneRecord*>(base + h->laneOffset);
+    slots_ = reinterpret_cast<const VehicleSlot*>(base + h->slotOffset);
+    return true;
+}
+
+void LevelPack::Close() {
+    if (!header_) return;
+    munmap(const_cast<Header*>(header_), size_);
+    header_ = nullptr;
+    seeds_ = nullptr;
+    lanes_ = nullptr;
+    slots_ = nullptr;
+    size_ = 0;
+}
+
+const SeedRecord* LevelPack::Find(const std::string& normSeed10, int gridW, int gridH, bool streamLanes) const {
+    if (!header_ || header_->gridW != static_cast<uint32_t>(gridW) || header_->gridH != static_cast<uint32_t>(gridH) ||
+        header_->streamLanes != (streamLanes ? 1u : 0u)) {
+        return nullptr;
+    }
+    char key[sizeof(SeedRecord::seed)] = {};
+    std::memcpy(key, normSeed10.data(), std::min(normSeed10.size(), sizeof key - 1));
+    const SeedRecord* end = seeds_ + header_->seedCount;
+    const SeedRecord* it = std::lower_bound(seeds_, end, key, [](const SeedRecord& r, const char* k) {
+        return CompareSeed(r.seed, k) < 0;
+    });
+    return (it != end && CompareSeed(it->seed, key) == 0) ? it : nullptr;
+}
+
+// ---------- compiler ----------
+
+static uint64_t AlignUp64(uint64_t n) { return (n + 63) & ~uint64_t{63}; }
+
+// Section offsets of a pack with these table sizes, in 64 bits so an oversized pack is
+// caught before the header's uint32 offsets wrap
+struct PackLayout {
+    uint64_t seedOffset, laneOffset, slotOffset, fileSize;
+};
+static PackLayout LayoutFor(uint64_t seeds, uint64_t lanes, uint64_t slots) {
+    PackLayout l;
+    l.seedOffset = AlignUp64(sizeof(Header));
+    l.laneOffset = AlignUp64(l.seedOffset + seeds * sizeof(SeedRecord));
+    l.slotOffset = AlignUp64(l.laneOffset + lanes * sizeof(LaneRecord));
+    l.fileSize = AlignUp64(l.slotOffset + slots * sizeof(VehicleSlot));
+    return l;
+}
+static bool TooLarge(const PackLayout& l, std::string& error) {
+    if (l.fileSize <= UINT32_MAX) return false;
+    error = "level pack could be up to " + std::to_string(l.fileSize >> 20) +
+            " MiB; the format's offsets limit it to 4 GiB (use fewer seeds or blocks)";
+    return true;
+}
+
+bool WriteLevelPack(const std::string& path, const std::vector<std::string>& seeds,
+                    const LevelPackOptions& opt, std::vector<SeedRecord>& compiled, std::string& error) {
+    compiled.clear();
+    if (opt.blocks < 1 || opt.gridW < 1 || opt.gridH < 1) {
+        error = "blocks and grid size must be positive";
+        return false;
+    }
+    const int lanesPerSeed = opt.blocks * kRowsPerBlock;
+    const int vehiclesPerLane = VehiclesPerLaneFor(opt.gridW);
+
+    // Normalize like the game, then sort so the loader can binary-search
+    Game game(opt.gridW, opt.gridH);
+    game.SetStreamLanes(opt.streamLanes);
+    std::vector<std::string> norm;
+    for (const std::string& s : seeds) {
+        if (s.empty()) continue;   // an empty seed means "random" in the game
+        game.ResetWithSeed(s, SDL_Color{0, 255, 0, 255}, 0);
+        norm.push_back(game.NormalizedSeed());
+    }
+    std::sort(norm.begin(), norm.end());
+    norm.erase(std::unique(norm.begin(), norm.end()), norm.end());
+    if (norm.empty()) {
+        error = "no seeds to compile";
+        return false;
+    }
+    // Refuse before generating anything if the pack could outgrow the format: every
+    // traffic row as a full vehicle loop (exact without stream lanes)
+    const uint64_t laneCount = static_cast<uint64_t>(norm.size()) * static_cast<uint64_t>(lanesPerSeed);
+    const uint64_t maxSlots = static_cast<uint64_t>(norm.size()) * static_cast<uint64_t>(opt.blocks) *
+                              (kRowsPerBlock - 2) * static_cast<uint64_t>(vehiclesPerLane);
+    if (TooLarge(LayoutFor(norm.size(), laneCount, maxSlots), error)) return false;
+
+    std::vector<LaneRecord> lanes;
+    std::vector<VehicleSlot> slots;
+    std::vector<VehicleSlot> pattern(static_cast<size_t>(vehiclesPerLane));
+    lanes.reserve(norm.size() * static_cast<size_t>(lanesPerSeed));
+    for (const std::string& seed : norm) {
+        game.ResetWithSeed(seed, SDL_Color{0, 255, 0, 255}, 0);
+        SeedRecord rec{};
+        std::memcpy(rec.seed, seed.data(), std::min(seed.size(), sizeof rec.seed - 1));
+        rec.matchSeed = game.MatchSeed();
+        rec.firstLane = static_cast<uint32_t>(lanes.size());
+        rec.tightestWindowSec = 0.f;
+        rec.tightestRow = -1;
+        double difficultySum = 0.0;
+
+        for (int row = 0; row < lanesPerSeed; ++row) {
+            const Lane lane = game.GenerateLane(row, pattern.data());
+            LaneRecord r{};
+            r.dir = lane.Dir() == Direction::Right ? 1 : 0;
+            r.minSpeed = lane.MinSpeed();
+            r.maxSpeed = lane.MaxSpeed();
+            r.baseSpeed = lane.BaseSpeed();
+            if (!lane.IsTraffic()) {
+                r.kind = kSafe;
+                r.dir = 0;
+            } else if (lane.IsStream()) {
+                r.kind = kStream;
+                r.spawnEverySec = lane.SpawnEverySec();
+                ++rec.streamLanes;
+            } else {
+                r.kind = kLoop;
+                r.slotCount = static_cast<uint16_t>(lane.VehicleCount());
+                r.firstSlot = static_cast<uint32_t>(slots.size());
+                r.loopLen = lane.LoopLenTiles();
+                r.maxLen = lane.MaxVehicleLen();
+                slots.insert(slots.end(), pattern.begin(), pattern.begin() + lane.VehicleCount());
+
+                // Static analysis of the loop: how much of it is vehicle, and how long the
+                // widest hole takes to pass a column at top speed
+                int covered = 0, widestGap = 0;
+                for (int i = 0; i < lane.VehicleCount(); ++i) {
+                    covered += pattern[static_cast<size_t>(i)].lengthTiles;
+                    widestGap = std::max(widestGap, pattern[static_cast<size_t>(i)].gapTiles);
+                }
+                difficultySum += static_cast<double>(covered) / static_cast<double>(r.loopLen) * r.baseSpeed;
+                const float window = static_cast<float>(widestGap) / std::max(0.1f, r.maxSpeed);
+                if (rec.tightestRow < 0 || window < rec.tightestWindowSec) {
+                    rec.tightestWindowSec = window;
+                    rec.tightestRow = row;
+                }
+                ++rec.trafficLanes;
+            }
+            lanes.push_back(r);
+        }
+        rec.difficulty = rec.trafficLanes ? static_cast<float>(difficultySum / rec.trafficLanes) : 0.f;
+        compiled.push_back(rec);
+    }
+
+    Header h{};
+    h.magic = kMagic;
+    h.version = kVersion;
+    h.generatorVersion = Game::kGeneratorVersion;
+    h.gridW = static_cast<uint32_t>(opt.gridW);
+    h.gridH = static_cast<uint32_t>(opt.gridH);
+    h.vehiclesPerLane = static_cast<uint32_t>(vehiclesPerLane);
+    h.streamLanes = opt.streamLanes ? 1 : 0;
+    h.blocks = static_cast<uint32_t>(opt.blocks);
+    h.lanesPerSeed = static_cast<uint32_t>(lanesPerSeed);
+    h.seedCount = static_cast<uint32_t>(compiled.size());
+    const PackLayout layout = LayoutFor(compiled.size(), lanes.size(), slots.size());
+    if (TooLarge(layout, error)) return false;
+    h.seedOffset = static_cast<uint32_t>(layout.seedOffset);
+    h.laneOffset = static_cast<uint32_t>(layout.laneOffset);
+    h.slotOffset = static_cast<uint32_t>(layout.slotOffset);
+    h.slotCount = static_cast<uint32_t>(slots.size());
+    h.fileSize = layout.fileSize;
+
+    std::vector<char> file(h.fileSize, 0);
+    std::memcpy(file.data(), &h, sizeof h);
+    std::memcpy(file.data() + h.seedOffset, compiled.data(), compiled.size() * sizeof(SeedRecord));
+    std::memcpy(file.data() + h.laneOffset, lanes.data(), lanes.size() * sizeof(LaneRecord));
+    if (!slots.empty()) std::memcpy(file.data() + h.slotOffset, slots.data(), slots.size() * sizeof(VehicleSlot));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(file.data(), static_cast<std::streamsize>(file.size()));
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
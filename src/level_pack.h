@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "frogger_levelpack.h"
+
+struct VehicleSlot;
+
+// A level pack mapped read-only (see frogger_levelpack.h). Open() validates the header
+// and every table index once; after that, a match start is a binary search over the
+// seed table and Games build their lanes directly on the mapped records.
+// Games hold pointers into the mapping, so the pack must outlive them.
+class LevelPack {
+public:
+    LevelPack() = default;
+    ~LevelPack() { Close(); }
+
+    LevelPack(const LevelPack&) = delete;
+    LevelPack& operator=(const LevelPack&) = delete;
+
+    // Returns false (and says why in 'error') if the file is missing, malformed, or was
+    // compiled by a different lane generator
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+    bool IsOpen() const { return header_ != nullptr; }
+
+    const frogger_pack::Header& Info() const { return *header_; }
+    int SeedCount() const { return header_ ? static_cast<int>(header_->seedCount) : 0; }
+    int LanesPerSeed() const { return header_ ? static_cast<int>(header_->lanesPerSeed) : 0; }
+    const frogger_pack::SeedRecord& Seed(int i) const { return seeds_[i]; }
+
+    // The record for a normalized seed, or nullptr if it isn't packed or the pack was built
+    // for another board (width, height, stream-lane setting)
+    const frogger_pack::SeedRecord* Find(const std::string& normSeed10, int gridW, int gridH,
+                                         bool streamLanes) const;
+
+    // World rows 0 .. LanesPerSeed()-1 of a seed, and the pattern table they index
+    const frogger_pack::LaneRecord* Lanes(const frogger_pack::SeedRecord& s) const { return lanes_ + s.firstLane; }
+    const VehicleSlot* Slots() const { return slots_; }
+
+private:
+    const frogger_pack::Header* header_ = nullptr;
+    const frogger_pack::SeedRecord* seeds_ = nullptr;
+    const frogger_pack::LaneRecord* lanes_ = nullptr;
+    const VehicleSlot* slots_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Offline side (frogger_levelpack): expand 'seeds' into a pack at 'path'. Seeds are
+// normalized like the game does; duplicates collapse. Returns false with 'error' set.
+struct LevelPackOptions {
+    int gridW = 15;
+    int gridH = 9;
+    int blocks = 8;
+    bool streamLanes = false;
+};
+bool WriteLevelPack(const std::string& path, const std::vector<std::string>& seeds,
+                    const LevelPackOptions& opt, std::vector<frogger_pack::SeedRecord>& compiled,
+                    std::string& error);
@@ -0,0 +1,75 @@
+// frogger_levelpack: compile curated seeds into a memory-mappable level pack.
+//
+//   frogger_levelpack -o season.flp [--grid-w N] [--blocks K] [--stream-lanes]
+//                     [--seeds FILE] [SEED ...]
+//
+// FILE lists one seed per line ('#' starts a comment). The pack only serves games
+// started with the same --grid-w / --stream-lanes.
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "level_pack.h"
+
+static int Usage() {
+    std::cerr << "usage: frogger_levelpack -o OUT [--grid-w N] [--blocks K] [--stream-lanes] "
+                 "[--seeds FILE] [SEED ...]\n";
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    LevelPackOptions opt;
+    std::string out;
+    std::vector<std::string> seeds;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            out = argv[++i];
+        } else if (arg == "--grid-w" && i + 1 < argc) {
+            opt.gridW = std::clamp(std::atoi(argv[++i]), 15, 960);
+        } else if (arg == "--blocks" && i + 1 < argc) {
+            opt.blocks = std::clamp(std::atoi(argv[++i]), 1, 4096);
+        } else if (arg == "--stream-lanes") {
+            opt.streamLanes = true;
+        } else if (arg == "--seeds" && i + 1 < argc) {
+            std::ifstream in(argv[++i]);
+            if (!in) {
+                std::cerr << "cannot read " << argv[i] << "\n";
+                return 1;
+            }
+            std::string line;
+            while (std::getline(in, line)) {
+                line = line.substr(0, line.find('#'));
+                line.erase(0, line.find_first_not_of(" \t\r"));
+                line.erase(line.find_last_not_of(" \t\r") + 1);
+                if (!line.empty()) seeds.push_back(line);
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            return Usage();
+        } else {
+            seeds.push_back(arg);
+        }
+    }
+    if (out.empty() || seeds.empty()) return Usage();
+
+    std::vector<frogger_pack::SeedRecord> compiled;
+    std::string error;
+    if (!WriteLevelPack(out, seeds, opt, compiled, error)) {
+        std::cerr << "frogger_levelpack: " << error << "\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const frogger_pack::SeedRecord& s : compiled) {
+        std::cout << s.seed << "  difficulty " << s.difficulty << "  tightest window "
+                  << s.tightestWindowSec << " s (row " << s.tightestRow << ")  "
+                  << s.trafficLanes << " loop / " << s.streamLanes << " stream rows\n";
+    }
+    std::cout << "Wrote " << out << ": " << compiled.size() << " seeds x " << opt.blocks << " blocks ("
+              << opt.blocks * frogger_pack::kRowsPerBlock << " rows), grid " << opt.gridW << "x" << opt.gridH
+              << (opt.streamLanes ? ", stream lanes" : "") << "\n";
+    return 0;
+}
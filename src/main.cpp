@@ -1,52 +1,122 @@
 #include <SDL2/SDL.h>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <condition_variable>
+#include <cmath>
+#include <cstdlib>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
 #include <random>
+#include <vector>
 
+#include "determinism.h"
+#include "frame_scheduler.h"
+#include "bot_driver.h"
 #include "game.h"
+#include "input_latency.h"
+#include "latency_trace.h"
+#include "level_pack.h"
 #include "render.h"
+#include "shm_export.h"
+#include "sim_pool.h"
+#include "soak_monitor.h"
+#include "thread_tuning.h"
 
-template <typename T>
-class TSQueue {
-public:
-    void push(const T& v) { std::lock_guard<std::mutex> lock(m_); q_.push(v); }
-    bool pop(T& out)      { std::lock_guard<std::mutex> lock(m_); if(q_.empty()) return false; out=q_.front(); q_.pop(); return true; }
-    void clear()          { std::lock_guard<std::mutex> lock(m_); std::queue<T> empty; std::swap(q_, empty); }
-private:
-    std::mutex m_;
-    std::queue<T> q_;
-};
+enum class AppState { Playing, GameOver };
 
-static void SimLoop(Game& game,
-                    TSQueue<InputAction>& inQ,
-                    std::atomic<bool>& stopFlag)
-{
-    using clock = std::chrono::steady_clock;
-    const double dt = 1.0 / 60.0;
-    auto next = clock::now();
+// Command-line options (all optional)
+struct AppOptions {
+    int simHz = 60;   // --sim-hz N : simulation tick rate; collisions are swept, so 20-30 is safe
+    bool checkDeterminism = false;   // --check-determinism : run a lockstep shadow per player
+    bool renderInline = false;   // --render-inline : draw on the event thread (no render thread)
+    int latencyReportSec = 0;   // --latency-report S : print input latency percentiles every S seconds
+    int players = 2;   // --players N : games shown as a mosaic; P1/P2 are on the keyboard
+    int simThreads = 0;   // --sim-threads W : sim worker threads (0 = one per core, minus the event and render threads)
+    int gridW = 15;   // --grid-w N : board width in tiles; wide boards get proportionally more traffic
+    bool streamLanes = false;   // --stream-lanes : some traffic rows become free-flowing pooled vehicles
+    std::string levelPack;   // --level-pack FILE : precompiled lanes for curated seeds (frogger_levelpack)
+    std::string shmName;   // --shm-name /name : publish live state to POSIX shared memory
+    // --pin-sim LIST / --pin-render LIST : CPU pinning ("2,3" or "2-5"); --sched-fifo P : sim
+    // workers run SCHED_FIFO at priority P; --nice N : nice level for sim and render threads
+    thread_tuning::Policy simTuning;
+    thread_tuning::Policy renderTuning;
+    std::string seed;   // --seed S : map seed; skips the prompt (for unattended runs)
+    bool seedGiven = false;
+    // --bots all|LIST : these players (1-based, "1,3-4") are bots; --bot-rate HZ : actions per
+    // second per bot (up to one per tick); --bot-policy random|UDLR... : random or a looped script
+    std::string bots;
+    double botRateHz = 10.0;
+    std::string botPolicy = "random";
+    int soakReportSec = -1;   // --soak-report S : soak health line every S seconds (default 60 with bots)
+    int durationSec = 0;   // --duration S : quit after S seconds (0 = run until closed)
+};
 
-    while (!stopFlag.load()) {
-        InputAction act;
-        while (inQ.pop(act)) {
-            game.HandleInput(act);
+static AppOptions ParseOptions(int argc, char** argv) {
+    AppOptions opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sim-hz" && i + 1 < argc) {
+            opt.simHz = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--players" && i + 1 < argc) {
+            opt.players = std::clamp(std::atoi(argv[++i]), 1, 64);
+        } else if (arg == "--sim-threads" && i + 1 < argc) {
+            opt.simThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--grid-w" && i + 1 < argc) {
+            opt.gridW = std::clamp(std::atoi(argv[++i]), 15, 960);
+        } else if (arg == "--stream-lanes") {
+            opt.streamLanes = true;
+        } else if (arg == "--level-pack" && i + 1 < argc) {
+            opt.levelPack = argv[++i];
+        } else if (arg == "--shm-name" && i + 1 < argc) {
+            opt.shmName = argv[++i];
+            if (opt.shmName.empty() || opt.shmName[0] != '/') opt.shmName.insert(0, "/");
+        } else if ((arg == "--pin-sim" || arg == "--pin-render") && i + 1 < argc) {
+            thread_tuning::Policy& p = (arg == "--pin-sim") ? opt.simTuning : opt.renderTuning;
+            if (!thread_tuning::ParseCpuList(argv[++i], p.cpus)) {
+                std::cerr << "Ignoring bad CPU list for " << arg << ": " << argv[i] << "\n";
+            }
+        } else if (arg == "--sched-fifo" && i + 1 < argc) {
+            opt.simTuning.fifoPriority = std::clamp(std::atoi(argv[++i]), 1, 99);
+        } else if (arg == "--nice" && i + 1 < argc) {
+            const int n = std::clamp(std::atoi(argv[++i]), -20, 19);
+            for (thread_tuning::Policy* p : { &opt.simTuning, &opt.renderTuning }) {
+                p->nice = n;
+                p->nicePending = true;
+            }
+        } else if (arg == "--check-determinism") {
+            opt.checkDeterminism = true;
+        } else if (arg == "--render-inline") {
+            opt.renderInline = true;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            opt.seed = argv[++i];
+            opt.seedGiven = true;
+        } else if (arg == "--bots" && i + 1 < argc) {
+            opt.bots = argv[++i];
+        } else if (arg == "--bot-rate" && i + 1 < argc) {
+            opt.botRateHz = std::atof(argv[++i]);
+        } else if (arg == "--bot-policy" && i + 1 < argc) {
+            opt.botPolicy = argv[++i];
+            if (!BotDriver::ValidPolicy(opt.botPolicy)) {
+                std::cerr << "Ignoring bad bot policy (random, or U/D/L/R letters): " << opt.botPolicy << "\n";
+                opt.botPolicy = "random";
+            }
+        } else if (arg == "--soak-report" && i + 1 < argc) {
+            opt.soakReportSec = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--duration" && i + 1 < argc) {
+            opt.durationSec = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--latency-report" && i + 1 < argc) {
+            opt.latencyReportSec = std::max(0, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Ignoring unknown option: " << arg << "\n";
         }
-
-        game.Update(static_cast<float>(dt));
-        if (game.IsGameOver()) break;
-
-        next += std::chrono::microseconds(static_cast<int>(dt * 1'000'000));
-        std::this_thread::sleep_until(next);
     }
+    return opt;
 }
 
-enum class AppState { Playing, GameOver };
-
 static std::string normalizeSeed(std::string s) {
     if (s.empty()) {
         std::mt19937_64 rng{std::random_device{}()};
@@ -60,104 +130,220 @@ static std::string normalizeSeed(std::string s) {
     return s.substr(0, 10);
 }
 
-static void ResetBoth(Game& gameA, Game& gameB, const std::string& seed, int gridW) {
-    SDL_Color green{0,255,0,255}, blue{0,0,255,255};
-    int startX = gridW / 2;
-    gameA.ResetWithSeed(seed, green, startX);
-    gameB.ResetWithSeed(seed, blue,  startX);
+// P1 and P2 keep their classic colors; remote players cycle through the rest
+static SDL_Color PlayerColor(int i) {
+    static const SDL_Color kPalette[] = {
+        {  0,255,  0,255}, {  0,  0,255,255}, {255,255,  0,255}, {255,  0,255,255},
+        {  0,255,255,255}, {255,128,  0,255}, {160, 96,255,255}, {255,255,255,255},
+    };
+    return kPalette[static_cast<size_t>(i) % (sizeof(kPalette) / sizeof(kPalette[0]))];
 }
 
-int main(int, char**) {
-    const int gridW = 15, gridH = 9, tile = 32;
-    std::cout << "Enter 10-char seed (any length; empty for random): ";
-    std::string userSeed;
-    std::getline(std::cin, userSeed);
+int main(int argc, char** argv) {
+    const AppOptions opt = ParseOptions(argc, argv);
+    const int gridW = opt.gridW, gridH = 9;
+    const int players = opt.players;
+    std::string userSeed = opt.seed;
+    if (!opt.seedGiven) {
+        std::cout << "Enter 10-char seed (any length; empty for random): ";
+        std::getline(std::cin, userSeed);
+    }
     std::string normalizedSeed = normalizeSeed(userSeed);
     std::cout << "Using seed: " << normalizedSeed << "\n";
 
-    Game gameA(gridW, gridH);
-    Game gameB(gridW, gridH);
-    ResetBoth(gameA, gameB, normalizedSeed, gridW);
+    // Mosaic with the column count that gives the largest tiles on a 1080p screen: near-square
+    // for classic boards, a single column for very wide ones. Tiles shrink so the whole grid
+    // fits; below 2 px tiles the Renderer scales the mosaic down into a window that fits.
+    int cols = 1;
+    double bestTile = 0.0;
+    for (int c = 1; c <= players; ++c) {
+        const int r = (players + c - 1) / c;
+        const double t = std::min(static_cast<double>(Renderer::kMaxWindowW) / (c * gridW),
+                                  static_cast<double>(Renderer::kMaxWindowH) / (r * gridH));
+        if (t > bestTile) { bestTile = t; cols = c; }
+    }
+    const int rows = (players + cols - 1) / cols;
+    const int tile = std::max(2, std::min({ 32, Renderer::kMaxWindowW / (cols * gridW),
+                                            Renderer::kMaxWindowH / (rows * gridH) }));
+    const int windowW = cols * gridW * tile;
+    const int windowH = rows * gridH * tile;
+
+    std::vector<bool> isBot(static_cast<size_t>(players), false);
+    if (opt.bots == "all") {
+        isBot.assign(isBot.size(), true);
+    } else if (!opt.bots.empty()) {
+        std::vector<int> numbers;
+        if (!thread_tuning::ParseCpuList(opt.bots, numbers)) {
+            std::cerr << "Ignoring bad player list for --bots: " << opt.bots << "\n";
+        }
+        for (int n : numbers) {
+            if (n >= 1 && n <= players) isBot[static_cast<size_t>(n - 1)] = true;
+        }
+    }
+
+    // Mapped before the games that point into it, so it outlives them
+    LevelPack pack;
+    if (!opt.levelPack.empty()) {
+        std::string error;
+        if (!pack.Open(opt.levelPack, error)) {
+            std::cerr << "Level pack " << opt.levelPack << " not used: " << error << "\n";
+        }
+    }
+
+    std::vector<std::unique_ptr<PlayerSlot>> slots;
+    slots.reserve(static_cast<size_t>(players));
+    for (int i = 0; i < players; ++i) {
+        slots.push_back(std::make_unique<PlayerSlot>(gridW, gridH, "P" + std::to_string(i + 1), PlayerColor(i)));
+        slots.back()->game.SetStreamLanes(opt.streamLanes);
+        if (pack.IsOpen()) slots.back()->game.SetLevelPack(&pack);
+        slots.back()->bot = isBot[static_cast<size_t>(i)];
+        // A bot's game is restarted by its worker, which a lockstep shadow can't follow
+        if (opt.checkDeterminism && !slots.back()->bot) {
+            slots.back()->shadow = std::make_unique<ShadowSim>(gridW, gridH, slots.back()->name);
+            // The shadow keeps generating live, so it also checks the pack against the generator
+            slots.back()->shadow->game.SetStreamLanes(opt.streamLanes);
+        }
+    }
+    // Only the first two players have keys; the rest are fed through their input queues.
+    // Bots take over their slot's keys, and a round only ends when every human is out.
+    const int keyboardPlayers = std::min(players, 2);
+    int humanKeyboardPlayers = 0;
+    for (int i = 0; i < keyboardPlayers; ++i) humanKeyboardPlayers += slots[static_cast<size_t>(i)]->bot ? 0 : 1;
+    const int startX = gridW / 2;
+    auto resetAll = [&]() {
+        for (auto& s : slots) {
+            s->input.clear();
+            s->game.ResetWithSeed(normalizedSeed, s->color, startX);
+        }
+    };
+    resetAll();
+    if (pack.IsOpen()) {
+        const frogger_pack::SeedRecord* rec = slots[0]->game.PackedSeed();
+        std::cout << "Level pack: " << pack.SeedCount() << " seeds, " << pack.LanesPerSeed() << " rows each; ";
+        if (rec) {
+            std::cout << "seed is packed (difficulty " << rec->difficulty << ", tightest window "
+                      << rec->tightestWindowSec << " s)\n";
+        } else {
+            std::cout << "seed not in pack for this board, generating live\n";
+        }
+    }
 
-    const int windowW = 2 * gridW * tile;
-    const int windowH = gridH * tile;
-    Renderer renderer("Frogger Split", windowW, windowH, tile);
-    if (!renderer.IsOk()) {
+    Renderer renderer(players == 2 ? "Frogger Split" : "Frogger Mosaic", windowW, windowH, tile);
+    if (!renderer.HasWindow()) {
         std::cerr << "SDL init failed.\n";
         return 1;
     }
+    // Grid lines would swamp small tiles
+    renderer.SetGridEnabled(tile >= 12);
 
-    TSQueue<InputAction> inA, inB;
-    std::atomic<bool> stopA{false}, stopB{false};
-    std::thread tA, tB;
-
-    auto startSession = [&]() {
-        stopA.store(false); stopB.store(false);
-        tA = std::thread(SimLoop, std::ref(gameA), std::ref(inA), std::ref(stopA));
-        tB = std::thread(SimLoop, std::ref(gameB), std::ref(inB), std::ref(stopB));
+    // This thread owns the window and the event queue. Drawing happens on a render thread
+    // (or here with --render-inline); the SDL renderer must be created on that thread.
+    struct RenderSetup {
+        bool ok = false;
+        bool vsync = false;
+        std::string tuning;   // what thread_tuning::Apply() reported
     };
-    auto endSession = [&]() {
-        stopA.store(true); stopB.store(true);
-        if (tA.joinable()) tA.join();
-        if (tB.joinable()) tB.join();
+    auto setUpRenderer = [&]() {
+        RenderSetup r;
+        r.tuning = thread_tuning::Apply(opt.renderTuning, 0);
+        r.ok = renderer.AttachRenderer();
+        r.vsync = r.ok && renderer.VsyncEnabled();
+        return r;
     };
 
-    startSession();
-
-    AppState state = AppState::Playing;
+    std::atomic<AppState> state{AppState::Playing};
+    std::atomic<bool> quit{false};
+    std::atomic<bool> forceRedraw{true};   // UI-only changes (state overlay, window expose)
+    std::unique_ptr<FrameScheduler> scheduler;
+    // Restart swaps the games out from under the views; a frame holds this from picking up
+    // the snapshots until its batch is built, so it never judges a new round by old views
+    std::mutex frameMutex;
     SDL_Rect playAgainBtn{ windowW/2 - 120, windowH/2 - 30, 240, 60 };
+    // Key press -> queue -> sim -> first frame showing it -> present, per stage
+    LatencyTracer tracer(players);
+    auto nextLatencyReport = FrameScheduler::clock::now() + std::chrono::seconds(opt.latencyReportSec);
+    // Long-run health (bots) and --duration, both checked by the drawing thread after a present
+    std::unique_ptr<SoakMonitor> soak;
+    FrameScheduler::clock::time_point runUntil{};
+    bool quitPosted = false;
 
-    bool quit = false;
-    while (!quit) {
-        SDL_Event e;
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) quit = true;
-            else if (e.type == SDL_KEYDOWN && e.key.repeat == 0) {
-                if (e.key.keysym.sym == SDLK_ESCAPE) quit = true;
-                else if (state == AppState::Playing) {
-                    if (e.key.keysym.sym == SDLK_w) inA.push(InputAction::Up);
-                    else if (e.key.keysym.sym == SDLK_s) inA.push(InputAction::Down);
-                    else if (e.key.keysym.sym == SDLK_a) inA.push(InputAction::Left);
-                    else if (e.key.keysym.sym == SDLK_d) inA.push(InputAction::Right);
-                    else if (e.key.keysym.sym == SDLK_UP)    inB.push(InputAction::Up);
-                    else if (e.key.keysym.sym == SDLK_DOWN)  inB.push(InputAction::Down);
-                    else if (e.key.keysym.sym == SDLK_LEFT)  inB.push(InputAction::Left);
-                    else if (e.key.keysym.sym == SDLK_RIGHT) inB.push(InputAction::Right);
-                } else if (state == AppState::GameOver) {
-                    if (e.key.keysym.sym == SDLK_r) {
-                        endSession();
-                        inA.clear();
-                        inB.clear();
-                        ResetBoth(gameA, gameB, normalizedSeed, gridW);
-                        startSession();
-                        state = AppState::Playing;
-                    }
-                }
-            } else if (e.type == SDL_MOUSEBUTTONDOWN && state == AppState::GameOver) {
-                int mx = e.button.x, my = e.button.y;
-                if (mx >= playAgainBtn.x && mx <= playAgainBtn.x + playAgainBtn.w &&
-                    my >= playAgainBtn.y && my <= playAgainBtn.y + playAgainBtn.h) {
-                    endSession();
-                    inA.clear();
-                    inB.clear();
-                    ResetBoth(gameA, gameB, normalizedSeed, gridW);
-                    startSession();
-                    state = AppState::Playing;
-                }
-            }
+    auto reportFrames = [&]() {
+        std::cout << "Frames  " << scheduler->AchievedFps() << " fps presented, "
+                  << scheduler->FramesSkipped() << " unchanged frames skipped, "
+                  << scheduler->IdlePercent() << "% idle, draw "
+                  << scheduler->MeanFrameWorkMs() << " ms mean / "
+                  << scheduler->WorstFrameWorkMs() << " ms worst\n";
+    };
+
+    // Bookkeeping for every present deadline, whether a frame went out or not, so the soak
+    // report and --duration keep running while nothing on screen moves
+    auto frameEnd = [&](bool presented) {
+        const auto now = FrameScheduler::clock::now();
+        if (opt.latencyReportSec > 0 && now >= nextLatencyReport) {
+            std::cout << tracer.LiveLine() << "\n";
+            nextLatencyReport += std::chrono::seconds(opt.latencyReportSec);
+        }
+        if (soak) {
+            if (presented) soak->FramePresented(now);
+            else soak->FrameSkipped(now);
+            const std::string line = soak->Poll(now);
+            if (!line.empty()) std::cout << line << "\n";
+        }
+        if (opt.durationSec > 0 && !quitPosted && now >= runUntil) {
+            // Leave through the event thread, like closing the window
+            SDL_Event q{};
+            q.type = SDL_QUIT;
+            SDL_PushEvent(&q);
+            quitPosted = true;
+        }
+    };
+
+    // Builds and presents one frame from the newest snapshots, on the thread that owns the renderer
+    auto drawFrame = [&](std::vector<const ViewSnapshot*>& views) {
+        std::unique_lock<std::mutex> lock(frameMutex);
+        // Every reader must pick up its newest snapshot, so no short-circuiting here
+        bool changed = false;
+        for (size_t i = 0; i < slots.size(); ++i) {
+            changed |= slots[i]->view.Acquire();
+            views[i] = &slots[i]->view.Front();
         }
 
-        if (state == AppState::Playing) {
-            if (gameA.IsGameOver() && gameB.IsGameOver()) {
+        if (state == AppState::Playing && humanKeyboardPlayers > 0) {
+            // The round ends when every human on the keyboard is out
+            bool allOver = true;
+            for (int i = 0; i < keyboardPlayers; ++i) {
+                if (!slots[static_cast<size_t>(i)]->bot) allOver = allOver && views[static_cast<size_t>(i)]->gameOver;
+            }
+            if (allOver) {
                 state = AppState::GameOver;
-                int sA = gameA.Score(), sB = gameB.Score();
-                std::string winner = (sA > sB) ? "Player 1 wins" : (sB > sA) ? "Player 2 wins" : "Tie";
-                std::cout << "Scores  P1:" << sA << "  P2:" << sB << "  -> " << winner << "\n";
+                forceRedraw = true;
+                int best = 0, bestScore = -1;
+                bool tie = false;
+                std::cout << "Scores ";
+                for (int i = 0; i < players; ++i) {
+                    const int sc = views[static_cast<size_t>(i)]->score;
+                    std::cout << " " << slots[static_cast<size_t>(i)]->name << ":" << sc;
+                    if (sc > bestScore) { best = i; bestScore = sc; tie = false; }
+                    else if (sc == bestScore) tie = true;
+                }
+                std::string winner = tie ? "Tie" : "Player " + std::to_string(best + 1) + " wins";
+                std::cout << "  -> " << winner << "\n";
+                reportFrames();
             }
         }
 
+        // Nothing moved and no UI change: keep the last presented frame
+        const bool force = forceRedraw.exchange(false);
+        if (!changed && !force) {
+            scheduler->FrameDone(false);
+            lock.unlock();
+            frameEnd(false);
+            return;
+        }
+
+        const auto drawStart = FrameScheduler::clock::now();
         renderer.BeginFrame();
-        renderer.DrawSplit(gameA, gameB);
+        renderer.DrawMosaic(views, cols);
 
         if (state == AppState::GameOver) {
             SDL_SetRenderDrawColor(renderer.Raw(), 0, 0, 0, 160);
@@ -168,11 +354,208 @@ int main(int, char**) {
             SDL_SetRenderDrawColor(renderer.Raw(), 10, 40, 10, 255);
             SDL_RenderDrawRect(renderer.Raw(), &playAgainBtn);
         }
+        scheduler->AddFrameWork(FrameScheduler::clock::now() - drawStart);
+        tracer.FrameBuilt(views);
+        lock.unlock();
 
+        // The present (and its vsync wait) runs while the sims and the event thread carry on
         renderer.EndFrame();
-        SDL_Delay(1);
+        tracer.FramePresented();
+        scheduler->FrameDone(true);
+        frameEnd(true);
+    };
+
+    // Render thread: paced by the scheduler, it sleeps until each present deadline and draws
+    std::promise<RenderSetup> renderReady;
+    std::promise<void> renderGo;
+    thread_tuning::Usage renderUsage;
+    auto renderMain = [&](std::future<void> go) {
+        const RenderSetup setup = setUpRenderer();
+        renderReady.set_value(setup);
+        if (setup.ok) {
+            go.wait();
+            const thread_tuning::Usage usageStart = thread_tuning::SampleThread();
+            std::vector<const ViewSnapshot*> views(static_cast<size_t>(players));
+            while (!quit) {
+                const auto sleepStart = FrameScheduler::clock::now();
+                std::this_thread::sleep_until(scheduler->Deadline());
+                scheduler->AddIdle(FrameScheduler::clock::now() - sleepStart);
+                if (quit) break;
+                drawFrame(views);
+            }
+            renderUsage = thread_tuning::Delta(usageStart, thread_tuning::SampleThread());
+        }
+        renderer.DetachRenderer();
+    };
+
+    RenderSetup setup;
+    std::thread renderThread;
+    if (opt.renderInline) {
+        setup = setUpRenderer();
+    } else {
+        renderThread = std::thread(renderMain, renderGo.get_future());
+        setup = renderReady.get_future().get();
+    }
+    if (!setup.ok) {
+        std::cerr << "SDL init failed.\n";
+        if (renderThread.joinable()) renderThread.join();
+        return 1;
+    }
+    scheduler = std::make_unique<FrameScheduler>(renderer.RefreshRateHz(), setup.vsync);
+
+    int simThreads = opt.simThreads;
+    if (simThreads == 0) {
+        const int hw = static_cast<int>(std::thread::hardware_concurrency());
+        simThreads = std::min(players, std::max(1, hw - (opt.renderInline ? 1 : 2)));
+    }
+    SimPool pool(slots, simThreads, opt.simHz);
+    pool.SetTuning(opt.simTuning);
+    pool.SetTracer(&tracer);
+    pool.SetBotRestart(normalizedSeed, startX);
+    BotDriver bots(slots, std::min(opt.botRateHz, static_cast<double>(opt.simHz)), opt.botPolicy, normalizedSeed);
+    if (bots.Bots() > 0) {
+        std::cout << bots.Bots() << " bots (" << opt.botPolicy << ") at "
+                  << std::min(opt.botRateHz, static_cast<double>(opt.simHz)) << " actions/s each\n";
+    }
+    const int soakReportSec = opt.soakReportSec >= 0 ? opt.soakReportSec : (bots.Bots() > 0 ? 60 : 0);
+    if (soakReportSec > 0) soak = std::make_unique<SoakMonitor>(pool, slots, renderer.RefreshRateHz(), soakReportSec);
+    runUntil = FrameScheduler::clock::now() + std::chrono::seconds(opt.durationSec);
+    std::cout << "Render thread" << (opt.renderInline ? " (inline with events): " : ": ") << setup.tuning << "\n";
+    thread_tuning::Usage eventUsageStart;
+    std::unique_ptr<ShmExporter> exporter;
+    if (!opt.shmName.empty()) {
+        exporter = std::make_unique<ShmExporter>(opt.shmName, players, gridW, gridH, opt.simHz);
+        if (exporter->IsOk()) {
+            pool.SetExporter(exporter.get());
+            std::cout << "Publishing live state to shared memory " << exporter->Name() << "\n";
+        } else {
+            exporter.reset();
+        }
+    }
+    std::cout << players << " players in a " << cols << "x" << rows << " mosaic (" << tile << " px tiles), "
+              << pool.Threads() << " sim threads\n";
+    if (renderer.Scaled()) {
+        std::cout << "Mosaic is " << windowW << "x" << windowH << " px even at " << tile
+                  << " px tiles; scaled down to a " << renderer.WindowW() << "x" << renderer.WindowH() << " window\n";
+    }
+
+    auto startSession = [&]() {
+        // Publish the freshly reset state before the sim workers take over the games
+        const float dt = 1.0f / static_cast<float>(opt.simHz);
+        if (exporter) exporter->BeginSession(slots[0]->game.NormalizedSeed());
+        for (size_t i = 0; i < slots.size(); ++i) {
+            PlayerSlot& s = *slots[i];
+            s.newestInput = InputTrace{};
+            s.game.FillSnapshot(s.view.WriteBuffer());
+            s.view.WriteBuffer().input = s.newestInput;
+            s.view.Publish();
+            if (exporter) exporter->Publish(static_cast<int>(i), s.game);
+            if (s.shadow) s.shadow->Start(normalizedSeed, s.color, startX, dt);
+        }
+        eventUsageStart = thread_tuning::SampleThread();
+        pool.Start();
+    };
+    auto endSession = [&]() {
+        pool.Stop();
+        uint64_t hits = 0, misses = 0;
+        for (auto& s : slots) {
+            if (s->shadow) std::cout << s->shadow->Stop() << "\n";
+            hits += s->game.PrefetchHits();
+            misses += s->game.PrefetchMisses();
+        }
+        std::cout << pool.Summary() << "\n";
+        std::cout << (opt.renderInline ? "  events+render: " : "  events: ") << thread_tuning::Describe(
+                         thread_tuning::Delta(eventUsageStart, thread_tuning::SampleThread())) << "\n";
+        std::cout << "Prefetch  " << hits << " hits " << misses << " misses\n";
+    };
+
+    startSession();
+    bots.Start();
+
+    auto restart = [&]() {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        endSession();
+        resetAll();
+        startSession();
+        state = AppState::Playing;
+        forceRedraw = true;
+    };
+
+    InputLatency blind;
+    auto handleEvent = [&](const SDL_Event& e) {
+        // Keys of a slot taken over by a bot are ignored
+        auto push = [&](PlayerSlot& s, InputAction act) {
+            if (!s.bot) s.input.push(QueuedInput{ act, tracer.Begin(e.key.timestamp) });
+        };
+        if (e.type == SDL_QUIT) quit = true;
+        else if (e.type == SDL_WINDOWEVENT) forceRedraw = true;
+        else if (e.type == SDL_KEYDOWN && e.key.repeat == 0) {
+            if (e.key.keysym.sym == SDLK_ESCAPE) quit = true;
+            else if (state == AppState::Playing) {
+                PlayerSlot& inA = *slots[0];
+                if (e.key.keysym.sym == SDLK_w) push(inA, InputAction::Up);
+                else if (e.key.keysym.sym == SDLK_s) push(inA, InputAction::Down);
+                else if (e.key.keysym.sym == SDLK_a) push(inA, InputAction::Left);
+                else if (e.key.keysym.sym == SDLK_d) push(inA, InputAction::Right);
+                else if (keyboardPlayers > 1) {
+                    PlayerSlot& inB = *slots[1];
+                    if (e.key.keysym.sym == SDLK_UP)         push(inB, InputAction::Up);
+                    else if (e.key.keysym.sym == SDLK_DOWN)  push(inB, InputAction::Down);
+                    else if (e.key.keysym.sym == SDLK_LEFT)  push(inB, InputAction::Left);
+                    else if (e.key.keysym.sym == SDLK_RIGHT) push(inB, InputAction::Right);
+                }
+            } else if (state == AppState::GameOver) {
+                if (e.key.keysym.sym == SDLK_r) restart();
+            }
+        } else if (e.type == SDL_MOUSEBUTTONDOWN && state == AppState::GameOver) {
+            int mx = e.button.x, my = e.button.y;
+            if (mx >= playAgainBtn.x && mx <= playAgainBtn.x + playAgainBtn.w &&
+                my >= playAgainBtn.y && my <= playAgainBtn.y + playAgainBtn.h) {
+                restart();
+            }
+        }
+    };
+
+    if (opt.renderInline) {
+        std::vector<const ViewSnapshot*> views(static_cast<size_t>(players));
+        while (!quit) {
+            // Block until an event arrives or the next present deadline, instead of spinning
+            SDL_Event e;
+            blind.BackAtQueue();
+            auto waitStart = FrameScheduler::clock::now();
+            int got = SDL_WaitEventTimeout(&e, scheduler->WaitBudgetMs());
+            scheduler->AddIdle(FrameScheduler::clock::now() - waitStart);
+            blind.AwayFromQueue();
+            if (got) {
+                handleEvent(e);
+                while (SDL_PollEvent(&e)) handleEvent(e);
+            }
+            if (quit || !scheduler->DeadlineReached()) continue;
+            drawFrame(views);
+        }
+    } else {
+        // Frame N is presented on the render thread while this thread keeps feeding
+        // frame N+1's inputs to the sims; it only ever waits on the event queue
+        renderGo.set_value();
+        while (!quit) {
+            SDL_Event e;
+            blind.BackAtQueue();
+            const int got = SDL_WaitEvent(&e);
+            blind.AwayFromQueue();
+            if (got) {
+                handleEvent(e);
+                while (SDL_PollEvent(&e)) handleEvent(e);
+            }
+        }
+        renderThread.join();
     }
 
+    bots.Stop();
     endSession();
+    if (!opt.renderInline) std::cout << "  render: " << thread_tuning::Describe(renderUsage) << "\n";
+    reportFrames();
+    std::cout << blind.Summary() << "\n";
+    std::cout << tracer.Dump() << "\n";
+    if (soak) std::cout << soak->Final() << "\n";
     return 0;
 }
@@ -1,29 +1,61 @@
 #include "render.h"
 #include "game.h"
-#include "frog.h"
 #include "lane.h"
 #include <vector>
 #include <algorithm>
 
-Renderer::Renderer(const std::string& title, int windowW, int windowH, int tileSize)
-: tileSize_(tileSize)
+Renderer::Renderer(const std::string& title, int contentW, int contentH, int tileSize)
+: tileSize_(tileSize), contentW_(contentW), contentH_(contentH), windowW_(contentW), windowH_(contentH)
 {
+    // Keep the aspect ratio when the content doesn't fit
+    const double fit = std::min({ 1.0, static_cast<double>(kMaxWindowW) / contentW,
+                                  static_cast<double>(kMaxWindowH) / contentH });
+    if (fit < 1.0) {
+        windowW_ = std::max(1, static_cast<int>(contentW * fit));
+        windowH_ = std::max(1, static_cast<int>(contentH * fit));
+    }
     SDL_Init(SDL_INIT_VIDEO);
     window_ = SDL_CreateWindow(
         title.c_str(),
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-        windowW, windowH,
+        windowW_, windowH_,
         SDL_WINDOW_SHOWN
     );
-    sdlRenderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
 }
 
 Renderer::~Renderer() {
-    if (sdlRenderer_) { SDL_DestroyRenderer(sdlRenderer_); sdlRenderer_ = nullptr; }
+    DetachRenderer();
     if (window_)      { SDL_DestroyWindow(window_);         window_      = nullptr; }
     SDL_QuitSubSystem(SDL_INIT_VIDEO);
 }
 
+bool Renderer::AttachRenderer() {
+    if (!window_) return false;
+    if (!sdlRenderer_) {
+        sdlRenderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        if (sdlRenderer_ && Scaled()) SDL_RenderSetLogicalSize(sdlRenderer_, contentW_, contentH_);
+        if (sdlRenderer_) atlas_ = std::make_unique<SpriteAtlas>(sdlRenderer_);
+    }
+    return IsOk();
+}
+
+void Renderer::DetachRenderer() {
+    atlas_.reset();   // texture must go before the renderer
+    if (sdlRenderer_) { SDL_DestroyRenderer(sdlRenderer_); sdlRenderer_ = nullptr; }
+}
+
+int Renderer::RefreshRateHz() const {
+    SDL_DisplayMode mode;
+    if (!window_ || SDL_GetWindowDisplayMode(window_, &mode) != 0) return 0;
+    return mode.refresh_rate;
+}
+
+bool Renderer::VsyncEnabled() const {
+    SDL_RendererInfo info;
+    if (!sdlRenderer_ || SDL_GetRendererInfo(sdlRenderer_, &info) != 0) return false;
+    return (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+}
+
 void Renderer::BeginFrame() {
     SDL_SetRenderDrawColor(sdlRenderer_, colBg_.r, colBg_.g, colBg_.b, colBg_.a);
     SDL_RenderClear(sdlRenderer_);
@@ -33,94 +65,135 @@ void Renderer::EndFrame() {
     SDL_RenderPresent(sdlRenderer_);
 }
 
-void Renderer::DrawSplit(const Game& left, const Game& right) {
-    const int viewW = left.GridW() * tileSize_;
-    const int viewH = left.GridH() * tileSize_;
-    SDL_Rect vpLeft{ 0, 0, viewW, viewH };
-    SDL_Rect vpRight{ viewW, 0, viewW, viewH };
+void Renderer::DrawMosaic(const std::vector<const ViewSnapshot*>& views, int cols) {
+    if (views.empty()) return;
+    cols = std::max(1, cols);
+    const int viewW = views.front()->gridW * tileSize_;
+    const int viewH = views.front()->gridH * tileSize_;
+    const int rows  = (static_cast<int>(views.size()) + cols - 1) / cols;
+
+    clearBatch_();
+    for (size_t i = 0; i < views.size(); ++i) {
+        const int cx = static_cast<int>(i) % cols, cy = static_cast<int>(i) / cols;
+        appendView_(*views[i], SDL_Rect{ cx * viewW, cy * viewH, viewW, viewH });
+    }
 
-    DrawGameView(left, vpLeft);
-    DrawGameView(right, vpRight);
+    // dividers between views
+    // vertical gutter = one full tile centered on the boundary; horizontal ones are thinner
+    const SDL_Color gutter{ 12, 12, 12, 255 };
+    const float gutterW = static_cast<float>(tileSize_);
+    const float gutterH = std::max(2.f, static_cast<float>(tileSize_) / 4.f);
+    const float totalW = static_cast<float>(std::min<int>(cols, static_cast<int>(views.size())) * viewW);
+    const float totalH = static_cast<float>(rows * viewH);
+    for (int c = 1; c < cols && c < static_cast<int>(views.size()); ++c) {
+        pushQuad_(SDL_FRect{ static_cast<float>(c * viewW) - gutterW / 2.f, 0.f, gutterW, totalH },
+                  Sprite::White, gutter);
+    }
+    for (int r = 1; r < rows; ++r) {
+        pushQuad_(SDL_FRect{ 0.f, static_cast<float>(r * viewH) - gutterH / 2.f, totalW, gutterH },
+                  Sprite::White, gutter);
+    }
 
-    // vertical divider between views
-    // vertical gutter = at least one full tile (use 2 tiles if you want extra margin)
-    int gutterW = std::max( tileSize_, tileSize_ );   // change to 2*tileSize_ if you prefer
-    int gutterX = vpLeft.w - gutterW/2;
+    flushBatch_();
+}
 
-    SDL_SetRenderDrawColor(sdlRenderer_, 12, 12, 12, 255);
-    SDL_Rect mid { gutterX, 0, gutterW, vpLeft.h };
-    SDL_RenderFillRect(sdlRenderer_, &mid);
+void Renderer::DrawGameView(const ViewSnapshot& view, const SDL_Rect& vp) {
+    clearBatch_();
+    appendView_(view, vp);
+    flushBatch_();
 }
 
-void Renderer::DrawGameView(const Game& game, const SDL_Rect& vp) {
+void Renderer::appendView_(const ViewSnapshot& view, const SDL_Rect& vp) {
     // Fill background (just in case)
-    SDL_SetRenderDrawColor(sdlRenderer_, colBg_.r, colBg_.g, colBg_.b, colBg_.a);
-    SDL_RenderFillRect(sdlRenderer_, &vp);
+    pushQuad_(SDL_FRect{ static_cast<float>(vp.x), static_cast<float>(vp.y),
+                         static_cast<float>(vp.w), static_cast<float>(vp.h) }, Sprite::White, colBg_);
 
-    drawLanes_(game, vp);
-    drawVehicles_(game, vp);
-    drawFrog_(game, vp);
-    if (drawGrid_) drawGridOverlay_(game, vp);
+    drawLanes_(view, vp);
+    drawVehicles_(view, vp);
+    drawFrog_(view, vp);
+    if (drawGrid_) drawGridOverlay_(view, vp);
 }
 
-SDL_Rect Renderer::tileToPxRect_(float tx, float ty, float tw, float th,
-                                 const SDL_Rect& vp, int gridH) const {
+void Renderer::pushQuad_(const SDL_FRect& dst, Sprite sprite, SDL_Color tint, bool flipX) {
+    const SDL_FRect& uv = atlas_->UV(sprite);
+    float u0 = uv.x, u1 = uv.x + uv.w;
+    if (flipX) std::swap(u0, u1);
+    const float v0 = uv.y, v1 = uv.y + uv.h;
+
+    const int base = static_cast<int>(verts_.size());
+    verts_.push_back(SDL_Vertex{ SDL_FPoint{ dst.x,         dst.y         }, tint, SDL_FPoint{ u0, v0 } });
+    verts_.push_back(SDL_Vertex{ SDL_FPoint{ dst.x + dst.w, dst.y         }, tint, SDL_FPoint{ u1, v0 } });
+    verts_.push_back(SDL_Vertex{ SDL_FPoint{ dst.x + dst.w, dst.y + dst.h }, tint, SDL_FPoint{ u1, v1 } });
+    verts_.push_back(SDL_Vertex{ SDL_FPoint{ dst.x,         dst.y + dst.h }, tint, SDL_FPoint{ u0, v1 } });
+    for (int i : { 0, 1, 2, 0, 2, 3 }) indices_.push_back(base + i);
+}
+
+void Renderer::flushBatch_() {
+    if (indices_.empty()) return;
+    SDL_RenderGeometry(sdlRenderer_, atlas_->Texture(),
+                       verts_.data(), static_cast<int>(verts_.size()),
+                       indices_.data(), static_cast<int>(indices_.size()));
+}
+
+SDL_FRect Renderer::tileToPxRect_(float tx, float ty, float tw, float th,
+                                  const SDL_Rect& vp, int gridH) const {
     // Flip Y: logical y=0 (bottom) -> pixel row (gridH-1)
     float flippedY = static_cast<float>(gridH) - (ty + th);
-    SDL_Rect r;
-    r.x = vp.x + static_cast<int>(tx * tileSize_);
-    r.y = vp.y + static_cast<int>(flippedY * tileSize_);
-    r.w = static_cast<int>(tw * tileSize_);
-    r.h = static_cast<int>(th * tileSize_);
+    SDL_FRect r;
+    r.x = static_cast<float>(vp.x) + tx * static_cast<float>(tileSize_);
+    r.y = static_cast<float>(vp.y) + flippedY * static_cast<float>(tileSize_);
+    r.w = tw * static_cast<float>(tileSize_);
+    r.h = th * static_cast<float>(tileSize_);
     return r;
 }
 
 
-void Renderer::drawLanes_(const Game& game, const SDL_Rect& vp) {
-    // Query lane snapshot to know lane types for background
-    std::vector<GameSnapshotLane> lanes;
-    game.SnapshotLanes(lanes);
+void Renderer::drawLanes_(const ViewSnapshot& view, const SDL_Rect& vp) {
+    const std::vector<GameSnapshotLane>& lanes = view.lanes;
 
-    const int rows = game.GridH();
-    // lanes vector is ordered front=top to back=bottom. We'll draw from top (y=0) to bottom.
+    const int rows = view.gridH;
+    // lanes vector is ordered front=top to back=bottom. One tile quad per cell so the art repeats.
     for (int logicalY = 0; logicalY < rows; ++logicalY) {
         const GameSnapshotLane& ln = lanes[ static_cast<size_t>(rows - 1 - logicalY) ];
-        SDL_Color c = (ln.type == LaneType::Safe) ? colLaneSafe_ : colLaneTraffic_;
-        SDL_SetRenderDrawColor(sdlRenderer_, c.r, c.g, c.b, c.a);
-        SDL_Rect rect = tileToPxRect_(0.f, static_cast<float>(logicalY),
-                                    static_cast<float>(game.GridW()), 1.f, vp, rows);
-        SDL_RenderFillRect(sdlRenderer_, &rect);
+        Sprite tile = (ln.type == LaneType::Safe) ? Sprite::Grass : Sprite::Road;
+        for (int x = 0; x < view.gridW; ++x) {
+            pushQuad_(tileToPxRect_(static_cast<float>(x), static_cast<float>(logicalY), 1.f, 1.f, vp, rows),
+                      tile, colTile_);
+        }
     }
 }
 
-void Renderer::drawVehicles_(const Game& game, const SDL_Rect& vp) {
-    SDL_SetRenderDrawColor(sdlRenderer_, colVehicle_.r, colVehicle_.g, colVehicle_.b, colVehicle_.a);
-    game.ForEachVehicle([&](const TileRect& trect){
-        SDL_Rect r = tileToPxRect_(trect.x, trect.y, trect.w, trect.h, vp, game.GridH());
-        SDL_RenderFillRect(sdlRenderer_, &r);
-    });
+void Renderer::drawVehicles_(const ViewSnapshot& view, const SDL_Rect& vp) {
+    const int rows = view.gridH;
+    for (const TileRect& trect : view.vehicles) {
+        // Sprite by length; the art faces right, so mirror it on left-moving lanes
+        const int row = static_cast<int>(trect.y);
+        const GameSnapshotLane& ln = view.lanes[ static_cast<size_t>(rows - 1 - row) ];
+        Sprite car = (trect.w > 2.5f) ? Sprite::Car3 : (trect.w > 1.5f ? Sprite::Car2 : Sprite::Car1);
+        pushQuad_(tileToPxRect_(trect.x, trect.y, trect.w, trect.h, vp, rows),
+                  car, colVehicle_, ln.dir == Direction::Left);
+    }
 }
 
-void Renderer::drawFrog_(const Game& game, const SDL_Rect& vp) {
-    const Frog& f = game.Player();
-    SDL_Color fc = f.GetColor();
-    SDL_SetRenderDrawColor(sdlRenderer_, fc.r, fc.g, fc.b, fc.a);
-    // Frog dimensions are 1x1 tile; convert from tile coords to pixels
-    SDL_Rect r = tileToPxRect_(static_cast<float>(f.GetX()), static_cast<float>(f.GetY()), 1.f, 1.f, vp, game.GridH());
-    SDL_RenderFillRect(sdlRenderer_, &r);
+void Renderer::drawFrog_(const ViewSnapshot& view, const SDL_Rect& vp) {
+    // Frog dimensions are 1x1 tile; the sprite is tinted with the player's color
+    pushQuad_(tileToPxRect_(static_cast<float>(view.frogX), static_cast<float>(view.frogY), 1.f, 1.f, vp, view.gridH),
+              Sprite::Frog, view.frogColor);
 }
 
-void Renderer::drawGridOverlay_(const Game& game, const SDL_Rect& vp) {
-    SDL_SetRenderDrawColor(sdlRenderer_, colGrid_.r, colGrid_.g, colGrid_.b, colGrid_.a);
+void Renderer::drawGridOverlay_(const ViewSnapshot& view, const SDL_Rect& vp) {
+    // One-pixel quads instead of line draws so the grid joins the same batch
+    const float x0 = static_cast<float>(vp.x), y0 = static_cast<float>(vp.y);
+    const float w = static_cast<float>(vp.w),  h = static_cast<float>(vp.h);
 
     // Vertical lines
-    for (int x = 0; x <= game.GridW(); ++x) {
-        int px = vp.x + x * tileSize_;
-        SDL_RenderDrawLine(sdlRenderer_, px, vp.y, px, vp.y + vp.h);
+    for (int x = 0; x <= view.gridW; ++x) {
+        float px = x0 + static_cast<float>(x * tileSize_);
+        pushQuad_(SDL_FRect{ px, y0, 1.f, h }, Sprite::White, colGrid_);
     }
     // Horizontal lines
-    for (int y = 0; y <= game.GridH(); ++y) {
-        int py = vp.y + y * tileSize_;
-        SDL_RenderDrawLine(sdlRenderer_, vp.x, py, vp.x + vp.w, py);
+    for (int y = 0; y <= view.gridH; ++y) {
+        float py = y0 + static_cast<float>(y * tileSize_);
+        pushQuad_(SDL_FRect{ x0, py, w, 1.f }, Sprite::White, colGrid_);
     }
 }
@@ -1,30 +1,57 @@
 #pragma once
 #include <SDL2/SDL.h>
+#include <memory>
 #include <string>
+#include <vector>
+#include "sprite_atlas.h"
 
 // Forward-declare to avoid coupling headers
-class Game;
+struct ViewSnapshot;
 
 class Renderer {
 public:
-    // windowW/ windowH are computed from (2 views) * (gridW * tileSize) by caller or via init helper
-    Renderer(const std::string& title, int windowW, int windowH, int tileSize);
+    // Largest window the mosaic asks for (a 1080p screen)
+    static constexpr int kMaxWindowW = 1920;
+    static constexpr int kMaxWindowH = 1080;
+
+    // contentW / contentH are computed from (views per row/column) * (grid * tileSize) by the
+    // caller; all drawing (and mouse coordinates) use that space. Content larger than
+    // kMaxWindowW x kMaxWindowH gets a window scaled down to fit, with the renderer's logical
+    // size set to the content. Creates the window only: call AttachRenderer() on the thread
+    // that will draw.
+    Renderer(const std::string& title, int contentW, int contentH, int tileSize);
     ~Renderer();
 
     // Disallow copy; allow move if desired later
     Renderer(const Renderer&) = delete;
     Renderer& operator=(const Renderer&) = delete;
 
-    bool IsOk() const { return window_ && sdlRenderer_; }
+    bool IsOk() const { return window_ && sdlRenderer_ && atlas_ && atlas_->IsOk(); }
+    bool HasWindow() const { return window_ != nullptr; }
+    // Window size on screen; smaller than the content when it had to be scaled down
+    int WindowW() const { return windowW_; }
+    int WindowH() const { return windowH_; }
+    bool Scaled() const { return windowW_ != contentW_ || windowH_ != contentH_; }
+
+    // SDL renderers belong to the thread that created them: create / destroy the
+    // renderer and atlas on the drawing thread. AttachRenderer() returns IsOk().
+    bool AttachRenderer();
+    void DetachRenderer();
+
+    // Display refresh rate of the window (0 if unknown) and whether present waits for vblank
+    int RefreshRateHz() const;
+    bool VsyncEnabled() const;
 
     // Clear the whole window to background
     void BeginFrame();
 
-    // Draw a single Game into a viewport (x,y,w,h in pixels)
-    void DrawGameView(const Game& game, const SDL_Rect& viewport);
+    // Draw a single published game view into a viewport (x,y,w,h in pixels).
+    // Lanes, vehicles, frog and grid go out as one SDL_RenderGeometry call on the atlas.
+    void DrawGameView(const ViewSnapshot& view, const SDL_Rect& viewport);
 
-    // Draw two games side-by-side (split screen). Both viewports are computed from grid/tile.
-    void DrawSplit(const Game& left, const Game& right);
+    // Draw N views as a grid with 'cols' views per row (2 views, 2 cols = classic split screen).
+    // Viewports are computed from grid/tile; every view goes into one geometry submission.
+    void DrawMosaic(const std::vector<const ViewSnapshot*>& views, int cols);
 
     // Present the frame
     void EndFrame();
@@ -37,24 +64,36 @@ public:
     int TileSize() const { return tileSize_; }
 
 private:
-    void drawLanes_(const Game& game, const SDL_Rect& vp);
-    void drawVehicles_(const Game& game, const SDL_Rect& vp);
-    void drawFrog_(const Game& game, const SDL_Rect& vp);
-    void drawGridOverlay_(const Game& game, const SDL_Rect& vp);
+    // These append quads to the geometry batch; nothing is submitted until flushBatch_()
+    void appendView_(const ViewSnapshot& view, const SDL_Rect& vp);
+    void drawLanes_(const ViewSnapshot& view, const SDL_Rect& vp);
+    void drawVehicles_(const ViewSnapshot& view, const SDL_Rect& vp);
+    void drawFrog_(const ViewSnapshot& view, const SDL_Rect& vp);
+    void drawGridOverlay_(const ViewSnapshot& view, const SDL_Rect& vp);
+
+    // Geometry batch: vertex/index buffers are reused frame to frame
+    void pushQuad_(const SDL_FRect& dst, Sprite sprite, SDL_Color tint, bool flipX = false);
+    void clearBatch_() { verts_.clear(); indices_.clear(); }
+    void flushBatch_();
 
     // Tile-to-pixel helpers inside a viewport
-    inline SDL_Rect tileToPxRect_(float tx, float ty, float tw, float th, const SDL_Rect& vp, int gridH) const;
+    inline SDL_FRect tileToPxRect_(float tx, float ty, float tw, float th, const SDL_Rect& vp, int gridH) const;
 
 private:
     SDL_Window*   window_      = nullptr;
     SDL_Renderer* sdlRenderer_ = nullptr;
+    std::unique_ptr<SpriteAtlas> atlas_;
     int tileSize_ = 32;
+    int contentW_ = 0, contentH_ = 0;
+    int windowW_ = 0, windowH_ = 0;
     bool drawGrid_ = true;
 
-    // palette
+    std::vector<SDL_Vertex> verts_;
+    std::vector<int> indices_;
+
+    // palette (vertex tints; lane tiles use the atlas colors as-is)
     SDL_Color colBg_         {  8,  8,  8, 255 }; // window background
-    SDL_Color colLaneSafe_   { 30,120, 30, 255 }; // safe lane
-    SDL_Color colLaneTraffic_{ 45, 45, 45, 255 }; // traffic lane asphalt
+    SDL_Color colTile_       {255,255,255, 255 }; // untinted
     SDL_Color colVehicle_    {200, 40, 40, 255 }; // red vehicles (can vary per lane if you want)
     SDL_Color colGrid_       { 80, 80, 80, 255 }; // grid lines
 };
@@ -0,0 +1,104 @@
+#include "shm_export.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "game.h"
+
+using namespace frogger_shm;
+
+ShmExporter::ShmExporter(const std::string& name, int playerCount, int gridW, int gridH, int simHz)
+: name_(name), playerCount_(playerCount) {
+    size_ = SegmentSize(static_cast<uint32_t>(playerCount));
+    // Always a fresh object: a segment left by an earlier run is unlinked, not resized, so
+    // readers still mapping it keep valid (if frozen) memory instead of faulting
+    shm_unlink(name_.c_str());
+    const int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "shm_open(" << name_ << ") failed: " << std::strerror(errno) << "\n";
+        return;
+    }
+    struct stat st{};
+    void* mem = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && ftruncate(fd, static_cast<off_t>(size_)) == 0) {
+        mem = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mem == MAP_FAILED) {
+        std::cerr << "Sizing/mapping shared memory " << name_ << " failed: " << std::strerror(errno) << "\n";
+        shm_unlink(name_.c_str());
+        return;
+    }
+
+    dev_ = static_cast<unsigned long long>(st.st_dev);
+    ino_ = static_cast<unsigned long long>(st.st_ino);
+    header_ = static_cast<Header*>(mem);
+    players_ = reinterpret_cast<PlayerRecord*>(static_cast<char*>(mem) + kHeaderSize);
+    header_->version = kVersion;
+    header_->playerOffset = static_cast<uint32_t>(kHeaderSize);
+    header_->playerStride = static_cast<uint32_t>(sizeof(PlayerRecord));
+    header_->playerCount = static_cast<uint32_t>(playerCount);
+    header_->gridW = static_cast<uint32_t>(gridW);
+    header_->gridH = static_cast<uint32_t>(gridH);
+    header_->simHz = static_cast<uint32_t>(simHz);
+    header_->writerPid = static_cast<uint64_t>(getpid());
+    // Magic goes last: readers treat the segment as valid once they see it
+    header_->magic.store(kMagic, std::memory_order_release);
+}
+
+ShmExporter::~ShmExporter() {
+    if (!header_) return;
+    // Tell readers still mapping this object that it is finished
+    header_->session.store(kSessionClosed, std::memory_order_release);
+    munmap(header_, size_);
+    const int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd < 0) return;
+    struct stat st{};
+    const bool ours = fstat(fd, &st) == 0 && static_cast<unsigned long long>(st.st_dev) == dev_ &&
+                      static_cast<unsigned long long>(st.st_ino) == ino_;
+    close(fd);
+    if (ours) shm_unlink(name_.c_str());
+}
+
+void ShmExporter::BeginSession(const std::string& seed10) {
+    if (!header_) return;
+    std::memset(header_->seed, 0, sizeof header_->seed);
+    std::memcpy(header_->seed, seed10.data(), std::min(seed10.size(), sizeof header_->seed - 1));
+    header_->session.fetch_add(1, std::memory_order_release);
+}
+
+void ShmExporter::Publish(int index, const Game& game) {
+    if (!header_ || index < 0 || index >= playerCount_) return;
+    PlayerRecord& rec = players_[index];
+
+    const uint32_t seq = rec.seq.load(std::memory_order_relaxed);
+    rec.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    PlayerState& st = rec.state;
+    st.tick = game.Tick();
+    st.stateHash = game.StateHash();
+    st.frogX = game.Player().GetX();
+    st.frogY = game.Player().GetY();
+    st.score = game.Score();
+    st.bottomRowWorld = game.BottomRowWorld();
+    st.lanesAdvanced = game.LanesAdvanced();
+    st.gameOver = game.IsGameOver() ? 1 : 0;
+    const int lanes = std::min(game.GridH(), kMaxLanes);
+    st.laneCount = static_cast<uint8_t>(lanes);
+    for (int y = 0; y < lanes; ++y) {
+        const Lane& ln = game.LaneAtRow(y);
+        LaneRecord& lr = st.lanes[y];
+        lr.worldRow = ln.WorldRow();
+        const bool loop = ln.IsTraffic() && !ln.IsStream();
+        lr.kind = !ln.IsTraffic() ? kSafe : (ln.IsStream() ? kStream : kLoop);
+        lr.dir = (ln.IsTraffic() && ln.Dir() == Direction::Right) ? 1 : 0;
+        lr.phase = loop ? ln.Phase() : 0.f;           // a stream lane's phase is its spawn clock
+        lr.loopLen = loop ? ln.LoopLenTiles() : 1.f;
+    }
+
+    rec.seq.store(seq + 2, std::memory_order_release);
+}
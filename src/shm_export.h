@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "frogger_shm.h"
+
+class Game;
+
+// Writer side of the live-state segment (schema in frogger_shm.h).
+// Creates and sizes a POSIX shared-memory object; each sim thread then publishes
+// its own players' records once per tick. Publish() is a few stores and a copy,
+// no syscalls and no allocation.
+class ShmExporter {
+public:
+    // name is a POSIX shm name such as "/frogger"
+    ShmExporter(const std::string& name, int playerCount, int gridW, int gridH, int simHz);
+    ~ShmExporter();   // unmaps the segment, and unlinks it unless a newer run took the name
+
+    ShmExporter(const ShmExporter&) = delete;
+    ShmExporter& operator=(const ShmExporter&) = delete;
+
+    bool IsOk() const { return header_ != nullptr; }
+    const std::string& Name() const { return name_; }
+
+    // New round: record the seed and bump the session counter before the sims start
+    void BeginSession(const std::string& seed10);
+
+    // Seqlock-publish player 'index' (called only from the thread that owns that Game)
+    void Publish(int index, const Game& game);
+
+private:
+    std::string name_;
+    size_t size_ = 0;
+    frogger_shm::Header* header_ = nullptr;
+    frogger_shm::PlayerRecord* players_ = nullptr;
+    int playerCount_ = 0;
+    // identity of the object we created, so exit never unlinks a newer run's segment
+    unsigned long long dev_ = 0;
+    unsigned long long ino_ = 0;
+};
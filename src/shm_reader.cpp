@@ -0,0 +1,66 @@
+#include "shm_reader.h"
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace frogger_shm;
+
+bool ShmReader::Open(const std::string& name) {
+    Close();
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    void* mem = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= kHeaderSize) {
+        size_ = static_cast<size_t>(st.st_size);
+        mem = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mem == MAP_FAILED) return false;
+
+    const Header* h = static_cast<const Header*>(mem);
+    // Magic is stored last by the writer: acquire it before reading the other fields
+    const bool valid = h->magic.load(std::memory_order_acquire) == kMagic && h->version == kVersion &&
+                       h->playerStride == sizeof(PlayerRecord) &&
+                       size_ >= SegmentSize(h->playerCount);
+    if (!valid) {
+        munmap(mem, size_);
+        return false;
+    }
+    header_ = h;
+    return true;
+}
+
+void ShmReader::Close() {
+    if (!header_) return;
+    munmap(const_cast<Header*>(header_), size_);
+    header_ = nullptr;
+    size_ = 0;
+}
+
+std::string ShmReader::Seed() const {
+    if (!header_) return {};
+    return std::string(header_->seed, strnlen(header_->seed, sizeof header_->seed));
+}
+
+bool ShmReader::Read(int player, PlayerState& out, int maxSpins) const {
+    if (!header_ || player < 0 || player >= PlayerCount()) return false;
+    const PlayerRecord* rec = reinterpret_cast<const PlayerRecord*>(
+        reinterpret_cast<const char*>(header_) + header_->playerOffset + static_cast<size_t>(player) * header_->playerStride);
+
+    for (int spin = 0; spin < maxSpins; ++spin) {
+        const uint32_t s0 = rec->seq.load(std::memory_order_acquire);
+        if (s0 & 1u) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::memcpy(&out, &rec->state, sizeof out);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (rec->seq.load(std::memory_order_relaxed) == s0) return s0 != 0;   // 0 = never written
+    }
+    return false;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "frogger_shm.h"
+
+// Reader side of the live-state segment, for external tools (analytics, overlays).
+// Maps the segment read-only; after Open() every read is plain loads with no syscalls.
+// Only depends on frogger_shm.h, so tools can link it without the game.
+class ShmReader {
+public:
+    ShmReader() = default;
+    ~ShmReader() { Close(); }
+
+    ShmReader(const ShmReader&) = delete;
+    ShmReader& operator=(const ShmReader&) = delete;
+
+    // Returns false if the segment doesn't exist yet or has the wrong magic/version
+    bool Open(const std::string& name);
+    void Close();
+    bool IsOpen() const { return header_ != nullptr; }
+
+    int PlayerCount() const { return header_ ? static_cast<int>(header_->playerCount) : 0; }
+    int GridW() const { return header_ ? static_cast<int>(header_->gridW) : 0; }
+    int GridH() const { return header_ ? static_cast<int>(header_->gridH) : 0; }
+    int SimHz() const { return header_ ? static_cast<int>(header_->simHz) : 0; }
+    uint32_t Session() const { return header_ ? header_->session.load(std::memory_order_acquire) : 0; }
+    // The writer of the mapped segment has exited; Open() again to pick up a new run.
+    // (A writer that crashed can't say so; its session just stops changing.)
+    bool WriterClosed() const { return Session() == frogger_shm::kSessionClosed; }
+    std::string Seed() const;
+
+    // Consistent copy of one player's latest tick. Retries while the writer is mid-update;
+    // gives up (returns false) after maxSpins torn reads so a dead writer can't hang the caller.
+    bool Read(int player, frogger_shm::PlayerState& out, int maxSpins = 1000) const;
+
+private:
+    const frogger_shm::Header* header_ = nullptr;
+    size_t size_ = 0;
+};
@@ -0,0 +1,183 @@
+#include "sim_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include "alloc_audit.h"
+
+SimPool::SimPool(std::vector<std::unique_ptr<PlayerSlot>>& slots, int threads, int simHz)
+: slots_(slots), simHz_(simHz) {
+    const int n = static_cast<int>(slots.size());
+    threads = std::max(1, std::min(threads, n));
+    workers_ = std::vector<Worker>(static_cast<size_t>(threads));
+    for (int i = 0; i < threads; ++i) workerNames_.push_back("sim" + std::to_string(i));
+    for (int i = 0; i < n; ++i) {
+        Worker& w = workers_[static_cast<size_t>(i % threads)];
+        w.slots.push_back(slots[static_cast<size_t>(i)].get());
+        w.slotIndex.push_back(i);
+    }
+}
+
+void SimPool::Start() {
+    stop_.store(false);
+    started_ = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        Worker& w = workers_[i];
+        w.gameTicks = w.busyNs = w.worstTickNs = 0;
+        w.ticks = 0;
+        w.lateTicks = 0;
+        w.worstLateNs = 0;
+        w.thread = std::thread(&SimPool::workerLoop_, this, std::ref(w), workerNames_[i].c_str());
+    }
+}
+
+void SimPool::Stop() {
+    stop_.store(true);
+    bool joined = false;
+    for (Worker& w : workers_) {
+        if (w.thread.joinable()) { w.thread.join(); joined = true; }
+    }
+    if (joined) ran_ = std::chrono::steady_clock::now() - started_;
+}
+
+void SimPool::workerLoop_(Worker& w, const char* name) {
+    using clock = std::chrono::steady_clock;
+    w.tuning = thread_tuning::Apply(tuning_, static_cast<int>(&w - workers_.data()));
+    const thread_tuning::Usage usageStart = thread_tuning::SampleThread();
+    const double dt = 1.0 / static_cast<double>(simHz_);
+    const auto period = std::chrono::microseconds(static_cast<int>(dt * 1'000'000));
+    auto next = clock::now();
+#ifdef FROGGER_ALLOC_AUDIT
+    // One second of warm-up lets the snapshot buffers reach their final capacity
+    alloc_audit::TickAudit audit(name, static_cast<uint64_t>(simHz_));
+#else
+    (void)name;
+#endif
+
+    while (!stop_.load()) {
+        const auto tickStart = clock::now();
+#ifdef FROGGER_ALLOC_AUDIT
+        audit.BeginTick();
+        int advancedBefore = 0;
+        for (PlayerSlot* s : w.slots) advancedBefore += s->game.LanesAdvanced();
+#endif
+        int live = 0;
+        bool restarted = false;
+        for (size_t k = 0; k < w.slots.size(); ++k) {
+            PlayerSlot* s = w.slots[k];
+            Game& game = s->game;
+            if (game.IsGameOver()) {
+                if (!s->bot) continue;
+                game.ResetWithSeed(botSeed_, s->color, botStartX_);
+                s->newestInput = InputTrace{};
+                s->restarts.fetch_add(1, std::memory_order_relaxed);
+                restarted = true;
+            }
+            ++live;
+
+            QueuedInput in;
+            while (s->input.pop(in)) {
+                if (s->shadow) s->shadow->steps.push(ReplayStep{ game.Tick(), false, in.action });
+                const bool locked = game.InputLocked();
+                const bool moved = game.HandleInput(in.action);
+                if (tracer_ && in.trace.id != 0) tracer_->Handled(in.trace, locked, moved, s->newestInput);
+            }
+
+            game.Update(static_cast<float>(dt));
+            if (s->shadow) {
+                s->shadow->steps.push(ReplayStep{ game.Tick(), true, InputAction::Up });
+                s->shadow->checker.Submit(0, game);
+            }
+
+            // Hand the new state to the render thread
+            ViewSnapshot& snap = s->view.WriteBuffer();
+            game.FillSnapshot(snap);
+            snap.input = s->newestInput;
+            s->view.Publish();
+            if (exporter_) exporter_->Publish(w.slotIndex[k], game);
+        }
+#ifdef FROGGER_ALLOC_AUDIT
+        int advancedAfter = 0;
+        for (PlayerSlot* s : w.slots) advancedAfter += s->game.LanesAdvanced();
+        if (restarted) audit.SkipTick();
+        else audit.EndTick(advancedAfter != advancedBefore);
+#else
+        (void)restarted;
+#endif
+        if (live == 0) break;   // every game on this worker is over
+
+        const uint64_t busy = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - tickStart).count());
+        w.ticks.fetch_add(1, std::memory_order_relaxed);
+        w.gameTicks += static_cast<uint64_t>(live);
+        w.busyNs += busy;
+        w.worstTickNs = std::max(w.worstTickNs, busy);
+
+        next += period;
+        const auto now = clock::now();
+        if (now > next) {
+            w.lateTicks.fetch_add(1, std::memory_order_relaxed);
+            const uint64_t late = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - next).count());
+            if (late > w.worstLateNs.load(std::memory_order_relaxed)) w.worstLateNs.store(late, std::memory_order_relaxed);
+        }
+
+        // Use the slack before the next tick to generate upcoming lanes,
+        // so a block scroll only splices ready lanes
+        bool more = true;
+        while (more && clock::now() < next) {
+            more = false;
+            for (PlayerSlot* s : w.slots) more |= s->game.PrefetchStep();
+        }
+        std::this_thread::sleep_until(next);
+    }
+    w.usage = thread_tuning::Delta(usageStart, thread_tuning::SampleThread());
+#ifdef FROGGER_ALLOC_AUDIT
+    std::cerr << audit.Summary() + "\n";
+#endif
+}
+
+SimPool::LiveStats SimPool::Live() const {
+    LiveStats s;
+    for (const Worker& w : workers_) {
+        s.ticks += w.ticks.load(std::memory_order_relaxed);
+        s.lateTicks += w.lateTicks.load(std::memory_order_relaxed);
+        s.worstLateNs = std::max(s.worstLateNs, w.worstLateNs.load(std::memory_order_relaxed));
+    }
+    return s;
+}
+
+SimPool::RunStats SimPool::Stats() const {
+    RunStats s;
+    uint64_t busyNs = 0, worstNs = 0, worstLateNs = 0;
+    for (const Worker& w : workers_) {
+        s.ticks += w.ticks; s.gameTicks += w.gameTicks; busyNs += w.busyNs; s.lateTicks += w.lateTicks;
+        worstNs = std::max(worstNs, w.worstTickNs);
+        worstLateNs = std::max(worstLateNs, w.worstLateNs.load());
+    }
+    const double wallNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(ran_).count());
+    s.usPerGameTick = s.gameTicks ? static_cast<double>(busyNs) / 1000.0 / static_cast<double>(s.gameTicks) : 0.0;
+    s.busyPct = wallNs > 0 ? 100.0 * static_cast<double>(busyNs) / (wallNs * static_cast<double>(workers_.size())) : 0.0;
+    s.worstTickMs = static_cast<double>(worstNs) / 1e6;
+    s.worstLateMs = static_cast<double>(worstLateNs) / 1e6;
+    return s;
+}
+
+std::string SimPool::Summary() const {
+    const RunStats s = Stats();
+    std::ostringstream os;
+    os.setf(std::ios::fixed);
+    os.precision(2);
+    os << "Sim  " << slots_.size() << " games on " << workers_.size() << " threads @" << simHz_ << " Hz: "
+       << s.usPerGameTick << " us per game-tick, workers " << s.busyPct
+       << "% busy, worst tick " << s.worstTickMs << " ms, "
+       << s.lateTicks << "/" << s.ticks << " ticks late";
+    if (s.lateTicks > 0) os << " (worst +" << s.worstLateMs << " ms)";
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        const Worker& w = workers_[i];
+        os << "\n  " << workerNames_[i] << " [";
+        for (size_t k = 0; k < w.slots.size(); ++k) os << (k ? " " : "") << w.slots[k]->name;
+        os << "] " << w.tuning << "; " << thread_tuning::Describe(w.usage);
+    }
+    return os.str();
+}
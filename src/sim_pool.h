@@ -0,0 +1,124 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "determinism.h"
+#include "game.h"
+#include "latency_trace.h"
+#include "shm_export.h"
+#include "thread_tuning.h"
+#include "triple_buffer.h"
+#include "ts_queue.h"
+
+// A queued action and, for key presses, its latency trace
+struct QueuedInput {
+    InputAction action;
+    InputTrace trace;
+};
+
+// One player's game plus the channels other threads use to talk to it
+struct PlayerSlot {
+    PlayerSlot(int gridW, int gridH, std::string playerName, SDL_Color frogColor)
+    : game(gridW, gridH), name(std::move(playerName)), color(frogColor) {}
+
+    Game game;                              // owned by one SimPool worker while running
+    TSQueue<QueuedInput> input;             // keyboard / remote inputs
+    InputTrace newestInput;                 // newest accepted traced input (sim worker; reset per session)
+    TripleBuffer<ViewSnapshot> view;        // published once per tick for the UI
+    std::unique_ptr<ShadowSim> shadow;      // --check-determinism only
+    std::string name;                       // "P1", "P2", ...
+    SDL_Color color;
+    bool bot = false;                       // --bots: fed by a BotDriver, restarted by its worker on game over
+    std::atomic<uint64_t> restarts{0};      // bot restarts since launch
+};
+
+// Fixed-rate simulation of many games on a small set of worker threads.
+// Slots are statically partitioned (slot i -> worker i % threads), so each Game is only
+// ever touched by one thread and its results don't depend on the pool size.
+class SimPool {
+public:
+    SimPool(std::vector<std::unique_ptr<PlayerSlot>>& slots, int threads, int simHz);
+    ~SimPool() { Stop(); }
+
+    SimPool(const SimPool&) = delete;
+    SimPool& operator=(const SimPool&) = delete;
+
+    void Start();
+    void Stop();   // signals and joins all workers; safe to call twice
+
+    int Threads() const { return static_cast<int>(workers_.size()); }
+
+    // Optional live-state export; each worker publishes its slots after every tick.
+    // Set before Start().
+    void SetExporter(ShmExporter* exporter) { exporter_ = exporter; }
+
+    // Optional input latency tracing: workers time traced inputs from queue to acceptance
+    // and stamp each snapshot with its player's newest accepted trace. Set before Start().
+    void SetTracer(LatencyTracer* tracer) { tracer_ = tracer; }
+
+    // Pinning / priority for the workers (worker k is thread k of the policy). Set before Start().
+    void SetTuning(const thread_tuning::Policy& policy) { tuning_ = policy; }
+
+    // Bot slots whose game ends are reset in place with this seed / start column, so a
+    // soak run never stops. Set before Start().
+    void SetBotRestart(const std::string& seed, int startX) { botSeed_ = seed; botStartX_ = startX; }
+
+    // Running totals since the last Start(), safe to read while the workers run
+    struct LiveStats {
+        uint64_t ticks = 0;
+        uint64_t lateTicks = 0;
+        uint64_t worstLateNs = 0;   // furthest any tick finished past its slot
+    };
+    LiveStats Live() const;
+
+    // Totals for the last Start()..Stop() run
+    struct RunStats {
+        uint64_t ticks = 0;
+        uint64_t gameTicks = 0;
+        uint64_t lateTicks = 0;
+        double usPerGameTick = 0.0;   // worker busy time per game ticked
+        double busyPct = 0.0;         // worker busy time over wall time, averaged over workers
+        double worstTickMs = 0.0;
+        double worstLateMs = 0.0;
+    };
+    RunStats Stats() const;
+
+    // Scaling report since the last Start(): per game-tick sim cost, worker load, worst tick,
+    // then one line per worker with its players, scheduling and CPU time / preemptions
+    std::string Summary() const;
+
+private:
+    struct Worker {
+        std::thread thread;
+        std::vector<PlayerSlot*> slots;
+        std::vector<int> slotIndex;   // position of each slot in the pool (export record)
+        // stats, written by the worker; the atomics are also read live (Live())
+        std::atomic<uint64_t> ticks{0};
+        uint64_t gameTicks = 0;
+        uint64_t busyNs = 0;
+        uint64_t worstTickNs = 0;
+        std::atomic<uint64_t> lateTicks{0};     // tick work overran the tick period
+        std::atomic<uint64_t> worstLateNs{0};
+        std::string tuning;       // what Apply() reported
+        thread_tuning::Usage usage;   // this run's CPU time and context switches
+    };
+
+    void workerLoop_(Worker& w, const char* name);
+
+    std::vector<std::unique_ptr<PlayerSlot>>& slots_;
+    std::vector<Worker> workers_;
+    std::vector<std::string> workerNames_;
+    int simHz_;
+    ShmExporter* exporter_ = nullptr;
+    std::string botSeed_;
+    int botStartX_ = 0;
+    LatencyTracer* tracer_ = nullptr;
+    thread_tuning::Policy tuning_;
+    std::atomic<bool> stop_{false};
+    std::chrono::steady_clock::time_point started_;
+    std::chrono::steady_clock::duration ran_{};
+};
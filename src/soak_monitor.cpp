@@ -0,0 +1,107 @@
+#include "soak_monitor.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+static double Ms(SoakMonitor::clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+static double Mb(uint64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+
+SoakMonitor::SoakMonitor(const SimPool& pool, const std::vector<std::unique_ptr<PlayerSlot>>& slots,
+                         int refreshHz, int reportSec)
+: pool_(pool), slots_(slots),
+  hitchGap_(std::chrono::duration_cast<clock::duration>(
+      std::chrono::duration<double>(1.5 / static_cast<double>(refreshHz > 0 ? refreshHz : 60)))),
+  interval_(std::chrono::seconds(std::max(1, reportSec))),
+  started_(clock::now()),
+  nextReport_(started_ + interval_),
+  startMemory_(ReadMemory()),
+  lastSim_(pool.Live()) {}
+
+SoakMonitor::Memory SoakMonitor::ReadMemory() {
+    Memory m;
+#ifdef __linux__
+    if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+        unsigned long long size = 0, resident = 0;
+        if (std::fscanf(f, "%llu %llu", &size, &resident) == 2) {
+            m.rssBytes = static_cast<uint64_t>(resident) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        }
+        std::fclose(f);
+    }
+    rusage ru{};
+    if (getrusage(RUSAGE_SELF, &ru) == 0) m.peakRssBytes = static_cast<uint64_t>(ru.ru_maxrss) * 1024u;   // KiB
+#endif
+    m.peakRssBytes = std::max(m.peakRssBytes, m.rssBytes);   // the two are sampled differently
+    return m;
+}
+
+uint64_t SoakMonitor::restarts_() const {
+    uint64_t n = 0;
+    for (const auto& s : slots_) n += s->restarts.load(std::memory_order_relaxed);
+    return n;
+}
+
+void SoakMonitor::FramePresented(clock::time_point now) {
+    frame_(now);
+}
+
+void SoakMonitor::FrameSkipped(clock::time_point now) {
+    frame_(now);
+    ++skipped_;
+}
+
+void SoakMonitor::frame_(clock::time_point now) {
+    if (lastPresent_ != clock::time_point{}) {
+        const clock::duration gap = now - lastPresent_;
+        worstGap_ = std::max(worstGap_, gap);
+        worstGapEver_ = std::max(worstGapEver_, gap);
+        if (gap > hitchGap_) { ++hitches_; ++totalHitches_; }
+    }
+    lastPresent_ = now;
+    ++frames_;
+    ++totalFrames_;
+}
+
+std::string SoakMonitor::Poll(clock::time_point now) {
+    if (now < nextReport_) return std::string();
+    const double secs = std::chrono::duration<double>(now - (nextReport_ - interval_)).count();
+    nextReport_ = now + interval_;
+
+    SimPool::LiveStats sim = pool_.Live();
+    if (sim.ticks < lastSim_.ticks) lastSim_ = SimPool::LiveStats{};   // the pool was restarted
+    const Memory mem = ReadMemory();
+    const auto up = std::chrono::duration_cast<std::chrono::seconds>(now - started_).count();
+
+    std::ostringstream os;
+    os.setf(std::ios::fixed);
+    os.precision(1);
+    os << "Soak  " << up / 3600 << "h" << (up / 60) % 60 << "m" << up % 60 << "s: "
+       << static_cast<double>(frames_) / secs << " fps (" << skipped_ << " unchanged), worst frame gap " << Ms(worstGap_) << " ms, "
+       << hitches_ << " hitches; ticks late " << sim.lateTicks - lastSim_.lateTicks << "/"
+       << sim.ticks - lastSim_.ticks << " (worst so far +" << static_cast<double>(sim.worstLateNs) / 1e6 << " ms); "
+       << "RSS " << Mb(mem.rssBytes) << " MB (peak " << Mb(mem.peakRssBytes) << "); "
+       << restarts_() << " bot restarts";
+    frames_ = skipped_ = hitches_ = 0;
+    worstGap_ = clock::duration::zero();
+    lastSim_ = sim;
+    return os.str();
+}
+
+std::string SoakMonitor::Final() const {
+    const Memory mem = ReadMemory();
+    const double secs = std::chrono::duration<double>(clock::now() - started_).count();
+    std::ostringstream os;
+    os.setf(std::ios::fixed);
+    os.precision(1);
+    os << "Soak total " << secs << " s: " << totalFrames_ << " frames, " << totalHitches_
+       << " hitches, worst frame gap " << Ms(worstGapEver_) << " ms; RSS "
+       << Mb(startMemory_.rssBytes) << " -> " << Mb(mem.rssBytes) << " MB (peak "
+       << Mb(mem.peakRssBytes) << "); " << restarts_() << " bot restarts";
+    return os.str();
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "sim_pool.h"
+
+// Health report for long unattended runs (--bots). Every interval it prints presentation
+// gaps, sim tick lateness and process memory, so hitches and leaks show up as trends
+// instead of anecdotes. Memory is read from /proc (Linux; zero elsewhere).
+class SoakMonitor {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // A present-to-present gap above 1.5 refresh periods counts as a hitch
+    SoakMonitor(const SimPool& pool, const std::vector<std::unique_ptr<PlayerSlot>>& slots,
+                int refreshHz, int reportSec);
+
+    // Render side, after each present
+    void FramePresented(clock::time_point now);
+    // Render side, at a present deadline skipped because nothing changed: the screen is
+    // still current, so it counts as an on-time frame, not as part of a gap
+    void FrameSkipped(clock::time_point now);
+
+    // Render side: one line for the interval since the last report, or "" if none is due
+    std::string Poll(clock::time_point now);
+
+    // Whole-run totals
+    std::string Final() const;
+
+private:
+    struct Memory {
+        uint64_t rssBytes = 0;
+        uint64_t peakRssBytes = 0;
+    };
+    static Memory ReadMemory();
+    uint64_t restarts_() const;
+    void frame_(clock::time_point now);
+
+    const SimPool& pool_;
+    const std::vector<std::unique_ptr<PlayerSlot>>& slots_;
+    clock::duration hitchGap_;
+    clock::duration interval_;
+    clock::time_point started_;
+    clock::time_point nextReport_;
+    clock::time_point lastPresent_{};
+    Memory startMemory_;
+
+    // current interval
+    uint64_t frames_ = 0;       // presented + skipped
+    uint64_t skipped_ = 0;
+    uint64_t hitches_ = 0;
+    clock::duration worstGap_{0};
+    SimPool::LiveStats lastSim_;
+
+    // whole run
+    uint64_t totalFrames_ = 0;
+    uint64_t totalHitches_ = 0;
+    clock::duration worstGapEver_{0};
+};
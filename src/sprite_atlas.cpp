@@ -0,0 +1,114 @@
+#include "sprite_atlas.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Cell rectangles in atlas pixels, indexed by Sprite
+constexpr SDL_Rect kCells[kSpriteCount] = {
+    { 0 * SpriteAtlas::kCell, 0,                   SpriteAtlas::kCell,     SpriteAtlas::kCell }, // White
+    { 1 * SpriteAtlas::kCell, 0,                   SpriteAtlas::kCell,     SpriteAtlas::kCell }, // Grass
+    { 2 * SpriteAtlas::kCell, 0,                   SpriteAtlas::kCell,     SpriteAtlas::kCell }, // Road
+    { 3 * SpriteAtlas::kCell, 0,                   SpriteAtlas::kCell,     SpriteAtlas::kCell }, // Frog
+    { 0 * SpriteAtlas::kCell, SpriteAtlas::kCell,  SpriteAtlas::kCell,     SpriteAtlas::kCell }, // Car1
+    { 1 * SpriteAtlas::kCell, SpriteAtlas::kCell,  2 * SpriteAtlas::kCell, SpriteAtlas::kCell }, // Car2
+    { 3 * SpriteAtlas::kCell, SpriteAtlas::kCell,  3 * SpriteAtlas::kCell, SpriteAtlas::kCell }, // Car3
+};
+
+struct Pixels {
+    std::vector<uint8_t> rgba = std::vector<uint8_t>(SpriteAtlas::kWidth * SpriteAtlas::kHeight * 4, 0);
+    void set(int x, int y, uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+        uint8_t* p = &rgba[static_cast<std::size_t>((y * SpriteAtlas::kWidth + x) * 4)];
+        p[0] = r; p[1] = g; p[2] = b; p[3] = a;
+    }
+};
+
+void paintTiles(Pixels& px) {
+    const int c = SpriteAtlas::kCell;
+    for (int y = 0; y < c; ++y) {
+        for (int x = 0; x < c; ++x) {
+            // White: solid, used for flat-colored quads (background, grid lines)
+            px.set(kCells[0].x + x, y, 255, 255, 255);
+            // Grass: base green with a fixed speckle pattern
+            bool speck = ((x * 7 + y * 13) % 11) == 0;
+            px.set(kCells[1].x + x, y, speck ? 20 : 30, speck ? 95 : 120, speck ? 20 : 30);
+            // Road: asphalt with a dashed lane marking along the top edge
+            bool dash = (y == 0) && (x % 8 < 4);
+            px.set(kCells[2].x + x, y, dash ? 160 : 45, dash ? 160 : 45, dash ? 120 : 45);
+        }
+    }
+}
+
+void paintFrog(Pixels& px) {
+    const int c = SpriteAtlas::kCell, ox = kCells[3].x;
+    const float mid = (c - 1) * 0.5f;
+    for (int y = 0; y < c; ++y) {
+        for (int x = 0; x < c; ++x) {
+            float dx = (x - mid) / 6.0f, dy = (y - mid) / 6.5f;
+            bool body = dx * dx + dy * dy <= 1.0f;
+            bool leg  = (x <= 2 || x >= c - 3) && (y <= 3 || y >= c - 4);
+            bool eye  = (y == 4) && (x == 5 || x == c - 6);
+            if (eye)       px.set(ox + x, y, 10, 10, 10);
+            else if (body) px.set(ox + x, y, 235, 235, 235);
+            else if (leg)  px.set(ox + x, y, 190, 190, 190);
+        }
+    }
+}
+
+void paintCar(Pixels& px, const SDL_Rect& cell) {
+    const int w = cell.w, h = cell.h;
+    for (int y = 2; y < h - 2; ++y) {
+        for (int x = 1; x < w - 1; ++x) {
+            bool corner = (y == 2 || y == h - 3) && (x == 1 || x == w - 2);
+            if (corner) continue;
+            bool window = (x >= w - 6 && x <= w - 4) && (y >= 5 && y <= h - 6);   // windshield, front = right
+            uint8_t v = window ? 60 : 245;
+            px.set(cell.x + x, cell.y + y, v, v, v);
+        }
+    }
+    // wheels
+    for (int wx : { 3, w - 5 }) {
+        for (int x = wx; x < wx + 3; ++x) {
+            px.set(cell.x + x, cell.y + 1, 15, 15, 15);
+            px.set(cell.x + x, cell.y + h - 2, 15, 15, 15);
+        }
+    }
+}
+
+} // namespace
+
+SpriteAtlas::SpriteAtlas(SDL_Renderer* renderer) {
+    // Artists can drop in a BMP with the same layout; otherwise use the built-in art
+    if (SDL_Surface* surf = SDL_LoadBMP("assets/atlas.bmp")) {
+        if (surf->w == kWidth && surf->h == kHeight) {
+            texture_ = SDL_CreateTextureFromSurface(renderer, surf);
+        }
+        SDL_FreeSurface(surf);
+    }
+    if (!texture_) texture_ = buildProcedural_(renderer);
+    if (texture_) SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND);
+
+    for (int i = 0; i < kSpriteCount; ++i) {
+        const SDL_Rect& c = kCells[i];
+        uv_[i] = SDL_FRect{ (c.x + 0.5f) / kWidth, (c.y + 0.5f) / kHeight,
+                            (c.w - 1.0f) / kWidth, (c.h - 1.0f) / kHeight };
+    }
+}
+
+SpriteAtlas::~SpriteAtlas() {
+    if (texture_) { SDL_DestroyTexture(texture_); texture_ = nullptr; }
+}
+
+SDL_Texture* SpriteAtlas::buildProcedural_(SDL_Renderer* renderer) {
+    Pixels px;
+    paintTiles(px);
+    paintFrog(px);
+    for (int i = static_cast<int>(Sprite::Car1); i <= static_cast<int>(Sprite::Car3); ++i) paintCar(px, kCells[i]);
+
+    SDL_Texture* tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                                         SDL_TEXTUREACCESS_STATIC, kWidth, kHeight);
+    if (!tex) return nullptr;
+    SDL_UpdateTexture(tex, nullptr, px.rgba.data(), kWidth * 4);
+    return tex;
+}
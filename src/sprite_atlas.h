@@ -0,0 +1,37 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <array>
+
+// Everything the game draws, packed into one texture
+enum class Sprite { White, Grass, Road, Frog, Car1, Car2, Car3 };
+constexpr int kSpriteCount = 7;
+
+// Sprite atlas: one SDL_Texture built (or loaded) once at startup.
+// Layout, in 16x16 px cells (an assets/atlas.bmp override must follow it):
+//   row 0: White, Grass, Road, Frog
+//   row 1: Car1 (1 cell), Car2 (2 cells), Car3 (3 cells)   -- cars face right
+// Frog and car art is light grey so the vertex color tints it (player / vehicle color).
+class SpriteAtlas {
+public:
+    static constexpr int kCell = 16;
+    static constexpr int kWidth = 6 * kCell;
+    static constexpr int kHeight = 2 * kCell;
+
+    explicit SpriteAtlas(SDL_Renderer* renderer);
+    ~SpriteAtlas();
+
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+    bool IsOk() const { return texture_ != nullptr; }
+    SDL_Texture* Texture() const { return texture_; }
+
+    // Normalized texture coordinates of a sprite (inset half a texel against bleeding)
+    const SDL_FRect& UV(Sprite s) const { return uv_[static_cast<int>(s)]; }
+
+private:
+    SDL_Texture* buildProcedural_(SDL_Renderer* renderer);
+
+    SDL_Texture* texture_ = nullptr;
+    std::array<SDL_FRect, kSpriteCount> uv_{};
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Fields of a Game's lockstep hash. Each has its own running hash so a checker can
+// name the part of the state that diverged first.
+enum class StateField { Frog, Lanes, World, Status };
+constexpr int kStateFieldCount = 4;
+
+inline const char* StateFieldName(StateField f) {
+    switch (f) {
+        case StateField::Frog:   return "frog";    // position / score after each accepted input
+        case StateField::Lanes:  return "lanes";   // traffic phases after each tick
+        case StateField::World:  return "world";   // scroll window and generated lane configs
+        case StateField::Status: return "status";  // tick count, game-over, input lock
+    }
+    return "?";
+}
+
+// Cheap 64-bit running-hash step (xor-multiply-xorshift)
+inline uint64_t HashMix(uint64_t h, uint64_t v) {
+    h ^= v + 0x9E3779B97F4A7C15ULL;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 31);
+}
+
+// Exact bit pattern of a float, so hashes catch any drift
+inline uint64_t FloatBits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof u);
+    return u;
+}
@@ -0,0 +1,106 @@
+#include "thread_tuning.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace thread_tuning {
+
+bool ParseCpuList(const std::string& text, std::vector<int>& out) {
+    out.clear();
+    std::stringstream ss(text);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        if (part.empty()) return false;
+        char* end = nullptr;
+        const long lo = std::strtol(part.c_str(), &end, 10);
+        long hi = lo;
+        if (*end == '-') hi = std::strtol(end + 1, &end, 10);
+        if (*end != '\0' || lo < 0 || hi < lo || hi > 1023) return false;
+        for (long c = lo; c <= hi; ++c) out.push_back(static_cast<int>(c));
+    }
+    return !out.empty();
+}
+
+std::string Apply(const Policy& policy, int index) {
+    std::ostringstream os;
+#ifdef __linux__
+    const char* sep = "";
+    if (!policy.cpus.empty()) {
+        const int cpu = policy.cpus[static_cast<size_t>(index) % policy.cpus.size()];
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        const int rc = pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+        os << sep << "cpu " << cpu;
+        if (rc != 0) os << " FAILED (" << std::strerror(rc) << ")";
+        sep = ", ";
+    }
+    if (policy.fifoPriority > 0) {
+        sched_param sp{};
+        sp.sched_priority = policy.fifoPriority;
+        const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+        os << sep << "SCHED_FIFO " << policy.fifoPriority;
+        if (rc != 0) os << " FAILED (" << std::strerror(rc) << ")";
+        sep = ", ";
+    } else if (policy.nicePending) {
+        // Linux nice values are per thread when addressed by tid
+        const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        const int rc = setpriority(PRIO_PROCESS, static_cast<id_t>(tid), policy.nice);
+        os << sep << "nice " << policy.nice;
+        if (rc != 0) os << " FAILED (" << std::strerror(errno) << ")";
+        sep = ", ";
+    }
+    if (os.tellp() == 0) os << "default scheduling";
+#else
+    (void)index;
+    const bool asked = !policy.cpus.empty() || policy.fifoPriority > 0 || policy.nicePending;
+    os << (asked ? "thread tuning unsupported on this platform" : "default scheduling");
+#endif
+    return os.str();
+}
+
+Usage SampleThread() {
+    Usage u;
+#ifdef __linux__
+    rusage ru{};
+    if (getrusage(RUSAGE_THREAD, &ru) == 0) {
+        u.userUs = static_cast<uint64_t>(ru.ru_utime.tv_sec) * 1000000u + static_cast<uint64_t>(ru.ru_utime.tv_usec);
+        u.systemUs = static_cast<uint64_t>(ru.ru_stime.tv_sec) * 1000000u + static_cast<uint64_t>(ru.ru_stime.tv_usec);
+        u.voluntarySwitches = static_cast<uint64_t>(ru.ru_nvcsw);
+        u.involuntarySwitches = static_cast<uint64_t>(ru.ru_nivcsw);
+    }
+    u.cpu = sched_getcpu();
+#endif
+    return u;
+}
+
+Usage Delta(const Usage& a, const Usage& b) {
+    Usage d;
+    d.userUs = b.userUs - a.userUs;
+    d.systemUs = b.systemUs - a.systemUs;
+    d.voluntarySwitches = b.voluntarySwitches - a.voluntarySwitches;
+    d.involuntarySwitches = b.involuntarySwitches - a.involuntarySwitches;
+    d.cpu = b.cpu;
+    return d;
+}
+
+std::string Describe(const Usage& u) {
+    std::ostringstream os;
+    os.setf(std::ios::fixed);
+    os.precision(1);
+    os << "cpu " << static_cast<double>(u.userUs + u.systemUs) / 1000.0 << " ms (user "
+       << static_cast<double>(u.userUs) / 1000.0 << ", sys " << static_cast<double>(u.systemUs) / 1000.0 << "), "
+       << u.involuntarySwitches << " preemptions, " << u.voluntarySwitches << " sleeps";
+    if (u.cpu >= 0) os << ", on cpu " << u.cpu;
+    return os.str();
+}
+
+} // namespace thread_tuning
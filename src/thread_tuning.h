@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scheduling controls and CPU accounting for the game's own threads (Linux; on other
+// platforms Apply() reports "unsupported" and usage counters read as zero).
+namespace thread_tuning {
+
+// How one class of threads (sim workers, the render thread) should be scheduled
+struct Policy {
+    std::vector<int> cpus;    // pin to these CPUs; thread k of the class takes cpus[k % size]; empty = no pinning
+    int fifoPriority = 0;     // > 0: SCHED_FIFO at this priority (needs CAP_SYS_NICE / rtprio limit)
+    int nice = 0;             // != 0: nice level for the thread (ignored under SCHED_FIFO)
+    bool nicePending = false; // set when --nice was given (nice 0 is a valid request)
+};
+
+// "2,3" / "4-7" / "0,2-3" -> CPU ids; returns false on a malformed list
+bool ParseCpuList(const std::string& text, std::vector<int>& out);
+
+// Apply 'policy' to the calling thread as thread number 'index' of its class.
+// Returns a short description of what took effect ("cpu 2, SCHED_FIFO 10"); failures
+// are included in the text rather than aborting, so the game still runs unprivileged.
+std::string Apply(const Policy& policy, int index);
+
+// CPU time and context switches of the calling thread (getrusage RUSAGE_THREAD)
+struct Usage {
+    uint64_t userUs = 0;
+    uint64_t systemUs = 0;
+    uint64_t voluntarySwitches = 0;     // blocked / slept
+    uint64_t involuntarySwitches = 0;   // preempted: another task took the CPU
+    int cpu = -1;                       // CPU it was last seen on
+};
+Usage SampleThread();
+
+// b - a, keeping b's cpu
+Usage Delta(const Usage& a, const Usage& b);
+
+// "cpu 123.4 ms (user 120.1, sys 3.3), 2 preemptions, 480 sleeps, on cpu 3"
+std::string Describe(const Usage& u);
+
+} // namespace thread_tuning
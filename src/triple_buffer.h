@@ -0,0 +1,36 @@
+#pragma once
+#include <array>
+#include <atomic>
+
+// Single-producer / single-consumer triple buffer.
+// The writer fills WriteBuffer() and calls Publish(); the reader calls Acquire()
+// and, if it returns true, Front() holds the newest published value.
+// Neither side ever blocks or copies; buffers keep their capacity between swaps.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side
+    T& WriteBuffer() { return bufs_[back_]; }
+    void Publish() {
+        int prev = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel);
+        back_ = prev & kIndexMask;
+    }
+
+    // Reader side: swap in the newest value. Returns false if nothing new was published.
+    bool Acquire() {
+        if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) return false;
+        int prev = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = prev & kIndexMask;
+        return true;
+    }
+    const T& Front() const { return bufs_[front_]; }
+
+private:
+    static constexpr int kIndexMask = 0x3;
+    static constexpr int kFresh     = 0x4;   // set on 'middle' when it holds an unread value
+
+    std::array<T, 3> bufs_{};
+    int back_  = 0;                  // owned by writer
+    std::atomic<int> middle_{1};     // shared hand-off slot (+ fresh bit)
+    int front_ = 2;                  // owned by reader
+};
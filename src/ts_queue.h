@@ -0,0 +1,15 @@
+#pragma once
+#include <mutex>
+#include <queue>
+
+// Mutex-protected FIFO used to hand work between threads (inputs, replay steps)
+template <typename T>
+class TSQueue {
+public:
+    void push(const T& v) { std::lock_guard<std::mutex> lock(m_); q_.push(v); }
+    bool pop(T& out)      { std::lock_guard<std::mutex> lock(m_); if(q_.empty()) return false; out=q_.front(); q_.pop(); return true; }
+    void clear()          { std::lock_guard<std::mutex> lock(m_); std::queue<T> empty; std::swap(q_, empty); }
+private:
+    std::mutex m_;
+    std::queue<T> q_;
+};
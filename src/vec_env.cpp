@@ -0,0 +1,188 @@
+#include "vec_env.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include "state_hash.h"
+
+static uint64_t HashSeedString(const std::string& s) {
+    // FNV-1a 64-bit, same as Game::SeedToU64
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) { h ^= c; h *= 1099511628211ULL; }
+    return h;
+}
+
+static VecEnvConfig Validated(VecEnvConfig cfg) {
+    cfg.gridW = std::clamp(cfg.gridW, 15, 960);
+    // A scroll needs the frog to climb 7 rows, into the next block's first safe row
+    cfg.gridH = std::clamp(cfg.gridH, 8, 64);
+    return cfg;
+}
+
+// Ten decimal digits from a hash; fits the small-string buffer
+static std::string SeedDigits(uint64_t h) {
+    char digits[11];
+    std::snprintf(digits, sizeof digits, "%010llu", static_cast<unsigned long long>(h % 10000000000ULL));
+    return std::string(digits, 10);
+}
+
+// Little-endian, so the layout doesn't depend on the host
+static void PutU16(uint8_t* out, int v) {
+    out[0] = static_cast<uint8_t>(v & 0xff);
+    out[1] = static_cast<uint8_t>((v >> 8) & 0xff);
+}
+
+VecEnv::VecEnv(const VecEnvConfig& cfg)
+: cfg_(Validated(cfg)),
+  dt_(1.0f / static_cast<float>(std::max(1, cfg.simHz))),
+  baseSeed_(cfg.seed.empty() ? std::random_device{}() : HashSeedString(cfg.seed)),
+  fixedSeed_(cfg.seed.empty() ? SeedDigits(baseSeed_) : cfg.seed) {
+    const int n = std::max(1, cfg_.numEnvs);
+    envs_.resize(static_cast<size_t>(n));
+    for (Env& e : envs_) {
+        e.game = std::make_unique<Game>(cfg_.gridW, cfg_.gridH);
+        e.game->SetStreamLanes(cfg_.streamLanes);
+    }
+
+    int threads = cfg_.threads > 0 ? cfg_.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, n));
+    for (int k = 0; k <= threads; ++k) {
+        chunkBegin_.push_back(static_cast<size_t>(n) * static_cast<size_t>(k) / static_cast<size_t>(threads));
+    }
+    // Chunk 0 runs on the caller
+    for (int k = 1; k < threads; ++k) workers_.emplace_back(&VecEnv::workerLoop_, this, k);
+}
+
+VecEnv::~VecEnv() {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        quit_ = true;
+    }
+    startCv_.notify_all();
+    for (std::thread& t : workers_) t.join();
+}
+
+uint64_t VecEnv::Episodes() const {
+    uint64_t n = 0;
+    for (const Env& e : envs_) n += e.episode;
+    return n;
+}
+
+void VecEnv::Reset(uint8_t* obs) {
+    job_ = Job{};
+    job_.reset = true;
+    job_.obs = obs;
+    runJob_();
+}
+
+void VecEnv::Step(const EnvAction* actions, uint8_t* obs, float* rewards, uint8_t* dones) {
+    job_ = Job{ false, actions, obs, rewards, dones };
+    runJob_();
+    steps_ += envs_.size();
+}
+
+void VecEnv::runJob_() {
+    if (!workers_.empty()) {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            ++generation_;
+            pending_ = static_cast<int>(workers_.size());
+        }
+        startCv_.notify_all();
+    }
+    runChunk_(0);
+    if (!workers_.empty()) {
+        std::unique_lock<std::mutex> lk(m_);
+        doneCv_.wait(lk, [&]{ return pending_ == 0; });
+    }
+}
+
+void VecEnv::workerLoop_(int chunk) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            startCv_.wait(lk, [&]{ return quit_ || generation_ != seen; });
+            if (quit_) return;
+            seen = generation_;
+        }
+        runChunk_(chunk);
+        bool last;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            last = (--pending_ == 0);
+        }
+        if (last) doneCv_.notify_one();
+    }
+}
+
+void VecEnv::runChunk_(int chunk) {
+    const size_t begin = chunkBegin_[static_cast<size_t>(chunk)];
+    const size_t end = chunkBegin_[static_cast<size_t>(chunk) + 1];
+    const size_t obsSize = static_cast<size_t>(ObsSize());
+    const Job& job = job_;
+
+    for (size_t i = begin; i < end; ++i) {
+        Env& env = envs_[i];
+        Game& game = *env.game;
+        uint8_t* obs = job.obs + i * obsSize;
+
+        if (job.reset) {
+            resetEnv_(env, i);
+            writeObs_(game, obs);
+            continue;
+        }
+
+        switch (job.actions[i]) {
+            case EnvAction::Noop:  break;
+            case EnvAction::Up:    game.HandleInput(InputAction::Up);    break;
+            case EnvAction::Down:  game.HandleInput(InputAction::Down);  break;
+            case EnvAction::Left:  game.HandleInput(InputAction::Left);  break;
+            case EnvAction::Right: game.HandleInput(InputAction::Right); break;
+        }
+        game.Update(dt_);
+
+        const int score = game.Score();
+        job.rewards[i] = static_cast<float>(score - env.lastScore);
+        env.lastScore = score;
+
+        ++env.episodeSteps;
+        const bool done = game.IsGameOver() ||
+                          (cfg_.maxEpisodeSteps > 0 && env.episodeSteps >= cfg_.maxEpisodeSteps);
+        job.dones[i] = done ? 1 : 0;
+        if (done) {
+            ++env.episode;
+            resetEnv_(env, i);
+        }
+        writeObs_(game, obs);
+    }
+}
+
+void VecEnv::resetEnv_(Env& env, size_t index) {
+    const SDL_Color green{0, 255, 0, 255};
+    const int startX = cfg_.gridW / 2;
+    if (!cfg_.varyMaps) {
+        env.game->ResetWithSeed(fixedSeed_, green, startX);
+    } else {
+        env.game->ResetWithSeed(SeedDigits(HashMix(HashMix(baseSeed_, index), env.episode)), green, startX);
+    }
+    env.lastScore = env.game->Score();
+    env.episodeSteps = 0;
+}
+
+void VecEnv::writeObs_(const Game& game, uint8_t* out) const {
+    const int W = cfg_.gridW;
+    const int H = cfg_.gridH;
+    std::memset(out, 0, static_cast<size_t>(W * H));
+    game.ForEachVehicle([&](const TileRect& r) {
+        // Mark every tile the vehicle covers any part of
+        const int row = static_cast<int>(r.y);
+        const int x0 = std::max(0, static_cast<int>(std::floor(r.x)));
+        const int x1 = std::min(W, static_cast<int>(std::ceil(r.x + r.w)));
+        uint8_t* cells = out + row * W;
+        for (int x = x0; x < x1; ++x) cells[x] = 1;
+    });
+    PutU16(out + W * H,     game.Player().GetX());
+    PutU16(out + W * H + 2, game.Player().GetY());
+}
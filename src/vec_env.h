@@ -0,0 +1,99 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "game.h"
+
+// Agent actions. Noop lets an agent wait for a gap in traffic.
+enum class EnvAction : uint8_t { Noop, Up, Down, Left, Right };
+
+struct VecEnvConfig {
+    int numEnvs = 64;
+    int threads = 0;             // 0 = one per core; the calling thread is one of them
+    int gridW = 15;              // clamped to [15, 960] like --grid-w
+    int gridH = 9;               // clamped to [8, 64]: 8 rows is the least that can scroll
+    int simHz = 60;              // one Step() advances every env by 1/simHz seconds
+    std::string seed;            // base seed; "" behaves like the game (random)
+    bool varyMaps = true;        // derive a new map seed per (env, episode); false replays one map
+                                 // (the seed, or one drawn at construction if it is "")
+    int maxEpisodeSteps = 0;     // truncate episodes after this many steps (0 = no limit)
+    bool streamLanes = false;    // Game::SetStreamLanes for every env
+};
+
+// Headless batch of N independent Games for bot training, stepped in lockstep.
+//
+// Observations go straight into one caller-owned buffer of NumEnvs() * ObsSize() bytes,
+// env-major. Per env: gridW*gridH occupancy bytes (row-major, row 0 = bottom screen row,
+// 1 = a vehicle covers part of the tile), then frog x and frog y in screen tiles as
+// little-endian uint16 (2 bytes each, unaligned; boards can be up to 960 wide).
+// Step() and Reset() don't allocate; envs are split into contiguous chunks across a
+// persistent worker pool, and an env whose episode ends is reset in the same step
+// (its reward/done describe the finished episode, its observation the new one).
+class VecEnv {
+public:
+    explicit VecEnv(const VecEnvConfig& cfg);
+    ~VecEnv();
+
+    VecEnv(const VecEnv&) = delete;
+    VecEnv& operator=(const VecEnv&) = delete;
+
+    int NumEnvs() const { return static_cast<int>(envs_.size()); }
+    int Threads() const { return static_cast<int>(workers_.size()) + 1; }
+    int ObsSize() const { return cfg_.gridW * cfg_.gridH + 4; }
+
+    // Reset every env and write the initial observations
+    void Reset(uint8_t* obs);
+
+    // actions[N] in; obs[N*ObsSize()], rewards[N] (score change), dones[N] (0/1) out
+    void Step(const EnvAction* actions, uint8_t* obs, float* rewards, uint8_t* dones);
+
+    uint64_t Steps() const { return steps_; }    // env steps since construction
+    uint64_t Episodes() const;                   // finished episodes since construction
+
+    // Direct access for debugging/visualizing one env (not while Step() runs)
+    const Game& EnvGame(int i) const { return *envs_[static_cast<size_t>(i)].game; }
+
+private:
+    struct Env {
+        std::unique_ptr<Game> game;
+        uint32_t episode = 0;
+        int lastScore = 0;
+        int episodeSteps = 0;
+    };
+
+    // What the current batch call asks each chunk to do
+    struct Job {
+        bool reset = false;
+        const EnvAction* actions = nullptr;
+        uint8_t* obs = nullptr;
+        float* rewards = nullptr;
+        uint8_t* dones = nullptr;
+    };
+
+    void runJob_();                          // fan the job out and run chunk 0 on the caller
+    void runChunk_(int chunk);
+    void workerLoop_(int chunk);
+    void resetEnv_(Env& env, size_t index);
+    void writeObs_(const Game& game, uint8_t* out) const;
+
+    VecEnvConfig cfg_;
+    float dt_;
+    uint64_t baseSeed_;
+    std::string fixedSeed_;                  // the map every episode plays when !varyMaps
+    std::vector<Env> envs_;
+    std::vector<size_t> chunkBegin_;         // chunk k covers [chunkBegin_[k], chunkBegin_[k+1])
+    uint64_t steps_ = 0;
+
+    std::vector<std::thread> workers_;
+    std::mutex m_;
+    std::condition_variable startCv_;
+    std::condition_variable doneCv_;
+    Job job_;
+    uint64_t generation_ = 0;                // bumped per job; workers run each generation once
+    int pending_ = 0;                        // worker chunks still running
+    bool quit_ = false;
+};
@@ -1,15 +1,11 @@
 #include "vehicle.h"
 
-Vehicle::Vehicle(int startX, int startY, int length, float speed, Direction dir, SDL_Color color)
+Vehicle::Vehicle(float startX, int startY, int length, float speed, Direction dir, SDL_Color color)
     : x_(startX), y_(startY), length_(length), speed_(speed), dir_(dir), color_(color) {}
 
 void Vehicle::Update(float deltaTime) {
     // Move horizontally depending on direction
-    if (dir_ == Direction::Right) {
-        x_ += speed_ * deltaTime;
-    } else {
-        x_ -= speed_ * deltaTime;
-    }
+    x_ = Advance(x_, speed_, dir_, deltaTime);
 }
 
 SDL_Rect Vehicle::GetRect(int tileSize) const {
@@ -23,9 +19,5 @@ SDL_Rect Vehicle::GetRect(int tileSize) const {
 
 bool Vehicle::IsOffScreen(int boardWidth) const {
     // If completely off the screen horizontally
-    if (dir_ == Direction::Right) {
-        return x_ > boardWidth;
-    } else {
-        return (x_ + length_) < 0;
-    }
+    return IsOffScreenAt(x_, length_, dir_, boardWidth);
 }
@@ -6,7 +6,7 @@ enum class Direction { Left, Right };
 class Vehicle {
 public:
     // Constructor
-    Vehicle(int startX, int startY, int length, float speed, Direction dir, SDL_Color color);
+    Vehicle(float startX, int startY, int length, float speed, Direction dir, SDL_Color color);
 
     // Update position based on speed and delta time
     void Update(float deltaTime);
@@ -25,9 +25,20 @@ public:
     // Checks if the vehicle is off-screen (for deletion)
     bool IsOffScreen(int boardWidth) const;
 
+    // The same movement / culling rules on raw fields, for VehiclePool's columns
+    static float Advance(float x, float speed, Direction dir, float deltaTime) {
+        return dir == Direction::Right ? x + speed * deltaTime : x - speed * deltaTime;
+    }
+    static bool IsOffScreenAt(float x, int length, Direction dir, int boardWidth) {
+        return dir == Direction::Right ? x > static_cast<float>(boardWidth)
+                                       : (x + static_cast<float>(length)) < 0.f;
+    }
+
+    float GetPosX() const { return x_; }
+
 private:
     float x_;            // horizontal position (float for smooth movement)
-    int y_;              // vertical position (lane index)
+    int y_;              // vertical position (lane index; world row when pooled)
     int length_;         // in tiles
     float speed_;        // tiles per second
     Direction dir_;
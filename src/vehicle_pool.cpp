@@ -0,0 +1,122 @@
+#include "vehicle_pool.h"
+#include <algorithm>
+#include "state_hash.h"
+
+VehiclePool::VehiclePool(int capacity) {
+    const size_t n = static_cast<size_t>(std::max(0, capacity));
+    x_.resize(n);
+    speed_.resize(n);
+    row_.resize(n);
+    length_.resize(n);
+    dir_.resize(n);
+    color_.resize(n);
+    slotOf_.resize(n);
+    denseOf_.resize(n);
+    slotGen_.assign(n, 0);
+    freeSlots_.reserve(n);
+    Clear();
+}
+
+void VehiclePool::Clear() {
+    live_ = 0;
+    freeSlots_.clear();
+    // Highest slot first on the stack, so slots are handed out 0, 1, 2, ...
+    for (size_t s = slotGen_.size(); s-- > 0;) {
+        freeSlots_.push_back(static_cast<uint32_t>(s));
+        ++slotGen_[s];   // outstanding handles go stale
+    }
+}
+
+VehicleHandle VehiclePool::Spawn(const Vehicle& v) {
+    if (freeSlots_.empty()) return {};
+    const uint32_t slot = freeSlots_.back();
+    freeSlots_.pop_back();
+
+    const int i = live_++;
+    x_[i] = v.GetPosX();
+    speed_[i] = v.GetSpeed();
+    row_[i] = v.GetY();
+    length_[i] = static_cast<uint8_t>(v.GetLength());
+    dir_[i] = v.GetDirection();
+    color_[i] = v.GetColor();
+    slotOf_[i] = slot;
+    denseOf_[slot] = static_cast<uint32_t>(i);
+    return VehicleHandle{ slot, slotGen_[slot] };
+}
+
+bool VehiclePool::IsAlive(VehicleHandle h) const {
+    return h.index < slotGen_.size() && slotGen_[h.index] == h.generation;
+}
+
+bool VehiclePool::Release(VehicleHandle h) {
+    if (!IsAlive(h)) return false;
+    releaseDense_(static_cast<int>(denseOf_[h.index]));
+    return true;
+}
+
+Vehicle VehiclePool::Get(VehicleHandle h) const {
+    const uint32_t i = denseOf_[h.index];
+    return Vehicle(x_[i], row_[i], length_[i], speed_[i], dir_[i], color_[i]);
+}
+
+void VehiclePool::releaseDense_(int i) {
+    const uint32_t slot = slotOf_[i];
+    ++slotGen_[slot];
+    freeSlots_.push_back(slot);
+
+    // Swap the last live vehicle into the hole
+    const int last = --live_;
+    if (i != last) {
+        x_[i] = x_[last];
+        speed_[i] = speed_[last];
+        row_[i] = row_[last];
+        length_[i] = length_[last];
+        dir_[i] = dir_[last];
+        color_[i] = color_[last];
+        slotOf_[i] = slotOf_[last];
+        denseOf_[slotOf_[i]] = static_cast<uint32_t>(i);
+    }
+}
+
+int VehiclePool::Update(float deltaTime, int boardWidth) {
+    for (int i = 0; i < live_; ++i) x_[i] = Vehicle::Advance(x_[i], speed_[i], dir_[i], deltaTime);
+
+    // Walk backwards so swap-remove only pulls in vehicles that were already checked
+    int released = 0;
+    for (int i = live_ - 1; i >= 0; --i) {
+        if (Vehicle::IsOffScreenAt(x_[i], length_[i], dir_[i], boardWidth)) {
+            releaseDense_(i);
+            ++released;
+        }
+    }
+    return released;
+}
+
+void VehiclePool::ReleaseRowsBelow(int row) {
+    for (int i = live_ - 1; i >= 0; --i) {
+        if (row_[i] < row) releaseDense_(i);
+    }
+}
+
+bool VehiclePool::CollidesSwept(int row, float px, float pw, float deltaTime, int boardWidth) const {
+    const float W = static_cast<float>(boardWidth);
+    for (int i = 0; i < live_; ++i) {
+        if (row_[i] != row) continue;
+        // Extent over [t, t+dt]: from the previous position to the current one
+        const float x1 = x_[i];
+        const float x0 = Vehicle::Advance(x1, speed_[i], dir_[i], -deltaTime);
+        const float lo = std::min(x0, x1);
+        const float hi = std::max(x0, x1) + static_cast<float>(length_[i]);
+        if (hi <= 0.f || lo >= W) continue;
+        if (px < hi && px + pw > lo) return true;
+    }
+    return false;
+}
+
+uint64_t VehiclePool::Fingerprint() const {
+    uint64_t h = static_cast<uint64_t>(live_);
+    for (int i = 0; i < live_; ++i) {
+        h = HashMix(h, (static_cast<uint64_t>(static_cast<uint32_t>(row_[i])) << 32) | FloatBits(x_[i]));
+    }
+    return h;
+}
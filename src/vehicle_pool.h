@@ -0,0 +1,71 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+#include "vehicle.h"
+
+// Stable reference to a pooled vehicle. The generation makes handles to a released
+// (and possibly reused) entity go stale instead of aliasing the new occupant.
+struct VehicleHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+    bool Valid() const { return index != UINT32_MAX; }
+};
+
+// Fixed-capacity pool of free-moving vehicles for stream lanes.
+// Live vehicles are packed at the front of structure-of-arrays columns, so the
+// per-tick move / cull pass and the per-row scans walk contiguous memory however
+// many are alive. Handles go through a sparse slot table (swap-remove keeps the
+// columns dense). All storage is allocated in the constructor; Spawn/Release never allocate.
+class VehiclePool {
+public:
+    explicit VehiclePool(int capacity = 0);
+
+    int Capacity() const { return static_cast<int>(slotGen_.size()); }
+    int Live() const { return live_; }
+
+    // Copies the vehicle's fields into the pool. Returns an invalid handle when full.
+    VehicleHandle Spawn(const Vehicle& v);
+    bool Release(VehicleHandle h);
+    bool IsAlive(VehicleHandle h) const;
+    Vehicle Get(VehicleHandle h) const;   // h must be alive
+
+    void Clear();
+
+    // Move every live vehicle by dt and release the ones that left [0, boardWidth)
+    // (Vehicle::IsOffScreenAt). Returns how many were released.
+    int Update(float deltaTime, int boardWidth);
+
+    // Release every vehicle on a world row below 'row' (rows that scrolled away)
+    void ReleaseRowsBelow(int row);
+
+    // Swept test against a 1-row player rect on world row 'row': each vehicle's extent
+    // over the last 'deltaTime' (after Update) must not overlap [px, px+pw)
+    bool CollidesSwept(int row, float px, float pw, float deltaTime, int boardWidth) const;
+
+    // fn(x, row, length, dir) for each live vehicle, dense order
+    template <typename Fn>
+    void ForEachLive(Fn&& fn) const {
+        for (int i = 0; i < live_; ++i) fn(x_[i], row_[i], static_cast<int>(length_[i]), dir_[i]);
+    }
+
+    // Order-sensitive hash of the live columns (lockstep checks)
+    uint64_t Fingerprint() const;
+
+private:
+    void releaseDense_(int i);
+
+    int live_ = 0;
+    // dense columns, [0, live_) are alive
+    std::vector<float> x_;
+    std::vector<float> speed_;
+    std::vector<int> row_;
+    std::vector<uint8_t> length_;
+    std::vector<Direction> dir_;
+    std::vector<SDL_Color> color_;
+    std::vector<uint32_t> slotOf_;     // dense index -> handle slot
+    // sparse handle table
+    std::vector<uint32_t> denseOf_;    // slot -> dense index (valid while alive)
+    std::vector<uint32_t> slotGen_;    // bumped on release
+    std::vector<uint32_t> freeSlots_;  // LIFO, so reuse order is deterministic
+};
@@ -0,0 +1,105 @@
+// Headless allocation audit of the simulation hot path (ctest: alloc_audit).
+//
+// Drives Games and a VecEnv through warm-up, then many ticks, block scrolls and
+// ResetWithSeed restarts, counting every operator new on this thread. Exits non-zero
+// if any tick after warm-up allocated.
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "alloc_audit.h"
+#include "game.h"
+#include "test_util.h"
+#include "vec_env.h"
+
+namespace {
+
+using namespace test_util;
+
+constexpr int kWarmupTicks = 600;
+constexpr int kTicks = 60000;
+
+// One game as a sim worker runs it: inputs, update, snapshot, then idle-time prefetch.
+// Hops up into gaps so it scrolls often, and restarts on game over and every few
+// thousand ticks, alternating between two seeds.
+bool AuditGame(const char* name, int gridW, bool streamLanes) {
+    const SDL_Color green{0, 255, 0, 255};
+    const std::vector<std::string> seeds = { "1234567890", "season7" };
+    Game game(gridW);
+    game.SetStreamLanes(streamLanes);
+    game.ResetWithSeed(seeds[0], green, gridW / 2);
+    ViewSnapshot snap;
+
+    alloc_audit::TickAudit audit(name, kWarmupTicks);
+    uint32_t rng = 0x9e3779b9u;
+    int restarts = 0;
+    for (int t = 0; t < kTicks; ++t) {
+        audit.BeginTick();
+        const int advancedBefore = game.LanesAdvanced();
+        bool restarted = false;
+        if (game.IsGameOver() || (t > 0 && t % 5000 == 0)) {
+            game.ResetWithSeed(seeds[static_cast<size_t>(++restarts) % seeds.size()], green, gridW / 2);
+            restarted = true;
+        }
+        InputAction action;
+        if (ScriptedInput(game, t, rng, action)) game.HandleInput(action);
+        game.Update(kDt);
+        game.FillSnapshot(snap);
+        while (game.PrefetchStep()) {}
+        audit.EndTick(game.LanesAdvanced() > (restarted ? 0 : advancedBefore));
+    }
+    std::printf("%s (%d restarts)\n", audit.Summary().c_str(), restarts);
+    return audit.Clean();
+}
+
+// VecEnv with episode truncation so auto-resets happen all the time. Steps fan out to
+// the env worker threads, so this counts allocations process-wide.
+bool AuditVecEnv(int threads) {
+    VecEnvConfig cfg;
+    cfg.numEnvs = 64;
+    cfg.threads = threads;
+    cfg.seed = "1234567890";
+    cfg.maxEpisodeSteps = 900;
+    cfg.streamLanes = true;
+    VecEnv env(cfg);
+    const size_t n = static_cast<size_t>(env.NumEnvs());
+    std::vector<uint8_t> obs(n * static_cast<size_t>(env.ObsSize())), dones(n);
+    std::vector<float> rewards(n);
+    std::vector<EnvAction> actions(n, EnvAction::Noop);
+    env.Reset(obs.data());
+
+    uint32_t rng = 12345;
+    uint64_t allocs = 0, badSteps = 0;
+    const int steps = kTicks / 10;
+    for (int t = 0; t < steps; ++t) {
+        for (EnvAction& a : actions) a = static_cast<EnvAction>(NextRand(rng) % 5);
+        const uint64_t before = alloc_audit::ProcessAllocCount();
+        env.Step(actions.data(), obs.data(), rewards.data(), dones.data());
+        const uint64_t n = alloc_audit::ProcessAllocCount() - before;
+        if (t >= kWarmupTicks && n > 0) { allocs += n; ++badSteps; }
+    }
+    std::printf("alloc audit VecEnv on %d threads: %llu allocations in %d steps after warm-up (%llu episodes)%s\n",
+                env.Threads(), static_cast<unsigned long long>(allocs), steps - kWarmupTicks,
+                static_cast<unsigned long long>(env.Episodes()), badSteps ? " (FAIL)" : "");
+    return badSteps == 0;
+}
+
+} // namespace
+
+int main() {
+    // Without the counting operator new every audit would trivially pass
+    const uint64_t before = alloc_audit::ThreadAllocCount();
+    ::operator delete(::operator new(1));
+    const bool counting = alloc_audit::ThreadAllocCount() != before;
+    if (!counting) {
+        std::printf("alloc audit: operator new is not instrumented (build without FROGGER_ALLOC_AUDIT?)\n");
+        return 1;
+    }
+
+    bool ok = true;
+    ok &= AuditGame("15 wide", 15, false);
+    ok &= AuditGame("15 wide, stream lanes", 15, true);
+    ok &= AuditGame("240 wide, stream lanes", 240, true);
+    ok &= AuditVecEnv(1);
+    ok &= AuditVecEnv(4);
+    return ok ? 0 : 1;
+}
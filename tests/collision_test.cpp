@@ -0,0 +1,77 @@
+// Swept lane collision (ctest: swept_collision).
+//
+// A lane with a single 1-tile vehicle on a 21-tile loop, stepped with a dt large enough
+// that the vehicle jumps clean over a 1-tile frog: neither its start nor its end
+// position touches the frog, so only the swept test can see the hit. Runs in both
+// directions, once within the loop and once across the wrap point (the swept phase
+// interval splits in two).
+#include <cstdio>
+#include <initializer_list>
+#include "lane.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace test_util;
+
+constexpr int kGridW = 15;
+constexpr int kRow = 3;            // screen row the lane is drawn on
+constexpr float kSpeed = 30.f;     // tiles/s
+constexpr float kBigDt = 0.25f;    // 7.5 tiles per step
+
+struct Probe {
+    float frogX;
+    bool hit;
+};
+
+// Screen x of the lane's only vehicle (offset 0)
+float VehicleX(const Lane& ln, Direction dir) {
+    return dir == Direction::Right ? -1.f + ln.Phase() : static_cast<float>(kGridW) - ln.Phase();
+}
+
+bool Overlaps(float vehicleX, float frogX) { return vehicleX < frogX + 1.f && vehicleX + 1.f > frogX; }
+
+// 'warmDt' positions the vehicle before the big step (0: start at phase 0)
+bool SweptStep(const char* name, Direction dir, float warmDt, std::initializer_list<Probe> probes) {
+    VehicleSlot slot{ 1, 20, 0.f };
+    Lane lane(0, LaneType::Traffic, dir, kSpeed, kSpeed, kSpeed, &slot, 1);
+    if (warmDt > 0.f) lane.Update(warmDt, 1.f);
+    const float before = VehicleX(lane, dir);
+    const float p0 = lane.Phase();
+    lane.Update(kBigDt, 1.f);
+    const float after = VehicleX(lane, dir);
+    const bool wrapped = lane.Phase() < p0;
+
+    bool ok = Expect(lane.LoopLenTiles() == 21.f, "%s: loop is %.1f tiles, expected 21", name, lane.LoopLenTiles());
+    ok &= Expect(wrapped == (warmDt > 0.f), "%s: step %s the wrap point", name, wrapped ? "crossed" : "did not cross");
+    for (const Probe& p : probes) {
+        const TileRect frog{ p.frogX, static_cast<float>(kRow), 1.f, 1.f };
+        const bool hit = lane.CollidesAtScreenRow(frog, kGridW, kRow);
+        std::printf("%s: vehicle x %.1f -> %.1f, frog at %.0f: %s\n", name, before, after, p.frogX, hit ? "hit" : "clear");
+        if (p.hit) {
+            // Only a tunnelling-proof test can report this one
+            ok &= Expect(!Overlaps(before, p.frogX) && !Overlaps(after, p.frogX),
+                         "%s: frog at %.0f overlaps an endpoint, so the case proves nothing", name, p.frogX);
+        }
+        ok &= Expect(hit == p.hit, "%s: frog at %.0f %s", name, p.frogX, p.hit ? "tunnelled through" : "hit by nothing");
+        // Another row never collides
+        const TileRect above{ p.frogX, static_cast<float>(kRow + 1), 1.f, 1.f };
+        ok &= Expect(!lane.CollidesAtScreenRow(above, kGridW, kRow), "%s: hit from the row above", name);
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    // Right: x = -1 + phase. Phase 0 -> 7.5 sweeps x over [-1, 7.5)
+    ok &= SweptStep("right", Direction::Right, 0.f, { { 3.f, true }, { 10.f, false } });
+    // Left: x = 15 - phase. Sweeps x over [7.5, 16)
+    ok &= SweptStep("left", Direction::Left, 0.f, { { 10.f, true }, { 3.f, false } });
+    // Across the wrap: phase 18 -> 25.5 = 4.5, so p0 < 0 and the step splits into
+    // [18, 21) (off screen) and [0, 4.5]
+    ok &= SweptStep("right, wrapping", Direction::Right, 0.6f, { { 2.f, true }, { 10.f, false } });
+    ok &= SweptStep("left, wrapping", Direction::Left, 0.6f, { { 12.f, true }, { 5.f, false } });
+    return ok ? 0 : 1;
+}
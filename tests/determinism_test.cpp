@@ -0,0 +1,111 @@
+// Lockstep determinism checking (ctest: determinism).
+//
+// Two Games fed the same inputs must hash alike on every tick, both stepped side by side
+// over several matches and with one replayed on a ShadowSim thread the way
+// --check-determinism runs it.
+// Then one game is perturbed (an extra accepted hop, or one tick with a different dt)
+// and the LockstepChecker must name the tick and the state field that diverged first.
+#include <cstdio>
+#include <string>
+#include "determinism.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace test_util;
+
+const SDL_Color kGreen{0, 255, 0, 255};
+constexpr int kTicks = 3000;
+constexpr int kPerturbTick = 400;
+
+enum class Perturb { None, ExtraHop, OddDt };
+
+bool SideBySide(const char* name, Perturb perturb, StateField expectField) {
+    Game a(15), b(15);
+    a.ResetWithSeed("1234567890", kGreen, 7);
+    b.ResetWithSeed("1234567890", kGreen, 7);
+    LockstepChecker checker(name);
+    uint32_t rng = 0x9e3779b9u;
+    long long perturbedAt = -1;
+    bool hashesEqual = true, diverged = false;
+    int t = 0, matches = 1;
+    for (; t < kTicks; ++t) {
+        if (a.IsGameOver() || b.IsGameOver()) {
+            if (perturb != Perturb::None) break;
+            // Both restart together, as a shadow does with its primary
+            diverged |= checker.Diverged();
+            a.ResetWithSeed("1234567890", kGreen, 7);
+            b.ResetWithSeed("1234567890", kGreen, 7);
+            checker.Reset();
+            ++matches;
+        }
+        InputAction action;
+        if (ScriptedInput(a, t, rng, action)) {
+            a.HandleInput(action);
+            b.HandleInput(action);
+        }
+        float dtB = kDt;
+        if (perturbedAt < 0 && t >= kPerturbTick) {
+            if (perturb == Perturb::ExtraHop) {
+                // Retried until the hop isn't swallowed by the input lock
+                b.HandleInput(b.Player().GetX() > 0 ? InputAction::Left : InputAction::Right);
+                if (b.FieldHash(StateField::Frog) != a.FieldHash(StateField::Frog)) perturbedAt = static_cast<long long>(b.Tick());
+            } else if (perturb == Perturb::OddDt) {
+                dtB = kDt * 1.001f;
+                perturbedAt = static_cast<long long>(b.Tick());
+            }
+        }
+        a.Update(kDt);
+        b.Update(dtB);
+        checker.Submit(0, a);
+        checker.Submit(1, b);
+        if (perturb == Perturb::None) hashesEqual &= a.StateHash() == b.StateHash();
+    }
+    const std::string summary = checker.Summary();
+    std::printf("%s (%d ticks, %d matches): %s\n", name, t, matches, summary.c_str());
+    if (perturb == Perturb::None) {
+        return Expect(hashesEqual && !diverged && !checker.Diverged(), "%s: identical inputs diverged", name);
+    }
+    if (!Expect(perturbedAt >= 0, "%s: the perturbation never took", name)) return false;
+    const std::string expect = "FIRST DIVERGENCE at tick " + std::to_string(perturbedAt) + " field '" +
+                               StateFieldName(expectField) + "'";
+    bool ok = Expect(checker.Diverged(), "%s: divergence not detected", name);
+    return ok & Expect(summary.find(expect) != std::string::npos, "%s: expected \"%s\"", name, expect.c_str());
+}
+
+// The primary on this thread, the shadow replaying its inputs on its own, as in sim_pool.
+// One match: a shadow can't follow a restart
+bool ShadowThread() {
+    Game primary(15);
+    ShadowSim shadow(15, 9, "shadow");
+    primary.ResetWithSeed("1234567890", kGreen, 7);
+    shadow.Start("1234567890", kGreen, 7, kDt);
+    uint32_t rng = 0x9e3779b9u;
+    int t = 0;
+    for (; t < kTicks && !primary.IsGameOver(); ++t) {
+        InputAction action;
+        if (ScriptedInput(primary, t, rng, action)) {
+            shadow.steps.push(ReplayStep{ primary.Tick(), false, action });
+            primary.HandleInput(action);
+        }
+        primary.Update(kDt);
+        shadow.steps.push(ReplayStep{ primary.Tick(), true, InputAction::Up });
+        shadow.checker.Submit(0, primary);
+    }
+    const std::string summary = shadow.Stop();
+    std::printf("shadow thread (%d ticks): %s\n", t, summary.c_str());
+    bool ok = Expect(!shadow.checker.Diverged(), "shadow thread diverged");
+    ok &= Expect(shadow.game.StateHash() == primary.StateHash(), "shadow ended in a different state");
+    return ok & Expect(summary.find(" 0 ticks compared") == std::string::npos, "shadow compared no ticks");
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok &= SideBySide("same inputs", Perturb::None, StateField::Frog);
+    ok &= SideBySide("extra hop", Perturb::ExtraHop, StateField::Frog);
+    ok &= SideBySide("odd dt", Perturb::OddDt, StateField::Lanes);
+    ok &= ShadowThread();
+    return ok ? 0 : 1;
+}
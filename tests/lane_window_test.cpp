@@ -0,0 +1,134 @@
+// Windowed lane scans against full scans (ctest: lane_window).
+//
+// Wide boards give loop lanes more slots than the linear-scan cutoff, so visible-vehicle
+// iteration and swept collision only walk the slice of slots whose offsets can reach the
+// screen or the frog (widened by the window slack). Generated 240-wide lanes are stepped
+// through many phases with random dt and difficulty, including steps that wrap, and
+// both queries must agree exactly with a scan of every slot.
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "game.h"
+#include "lane.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace test_util;
+
+constexpr int kGridW = 240;
+constexpr int kRows = 160;
+constexpr int kSteps = 1500;
+constexpr int kScreenRow = 4;
+
+// Every slot's screen x, culled to [0, gridW)
+std::vector<float> VisibleFullScan(const Lane& ln, const VehicleSlot* slots) {
+    std::vector<float> xs;
+    const float W = static_cast<float>(kGridW);
+    for (int i = 0; i < ln.VehicleCount(); ++i) {
+        const float w = static_cast<float>(slots[i].lengthTiles);
+        const float x = ln.Dir() == Direction::Right ? -w + (ln.Phase() - slots[i].offset)
+                                                     : W + (slots[i].offset - ln.Phase());
+        if (x + w <= 0.f || x >= W) continue;
+        xs.push_back(x);
+    }
+    return xs;
+}
+
+// Every slot's extent over the last step of 'advance' tiles, as in the pre-window lane
+bool CollidesFullScan(const Lane& ln, const VehicleSlot* slots, float advance, const TileRect& frog) {
+    const float L = ln.LoopLenTiles();
+    const float p1 = ln.Phase();
+    const float p0 = p1 - std::min(advance, L);
+    const float segLo[2] = { p0 >= 0.f ? p0 : p0 + L, 0.f };
+    const float segHi[2] = { p0 >= 0.f ? p1 : L, p1 };
+    const int segs = p0 >= 0.f ? 1 : 2;
+    const float W = static_cast<float>(kGridW);
+    for (int i = 0; i < ln.VehicleCount(); ++i) {
+        const float w = static_cast<float>(slots[i].lengthTiles);
+        for (int k = 0; k < segs; ++k) {
+            const float lo = ln.Dir() == Direction::Right ? -w + (segLo[k] - slots[i].offset) : W + (slots[i].offset - segHi[k]);
+            const float hi = ln.Dir() == Direction::Right ? segHi[k] - slots[i].offset : W + (slots[i].offset - segLo[k]) + w;
+            if (hi <= 0.f || lo >= W) continue;
+            if (frog.x < hi && frog.x + frog.w > lo) return true;
+        }
+    }
+    return false;
+}
+
+template <Direction D>
+std::vector<float> VisibleAs(const Lane& ln) {
+    std::vector<float> xs;
+    ln.ForEachVisibleVehicleAs<D>(kGridW, kScreenRow, [&](const TileRect& r) { xs.push_back(r.x); });
+    return xs;
+}
+
+} // namespace
+
+int main() {
+    Game game(kGridW);
+    game.ResetWithSeed("1234567890", SDL_Color{0, 255, 0, 255}, kGridW / 2);
+    const int perLane = game.VehiclesPerLane();
+    std::vector<VehicleSlot> slotBuf(static_cast<size_t>(kRows) * static_cast<size_t>(perLane));
+    std::vector<Lane> lanes;
+    std::vector<const VehicleSlot*> laneSlots;
+    for (int r = 0; r < kRows; ++r) {
+        VehicleSlot* slots = slotBuf.data() + static_cast<size_t>(r) * static_cast<size_t>(perLane);
+        Lane ln = game.GenerateLane(r, slots);
+        if (!ln.IsTraffic()) continue;
+        lanes.push_back(ln);
+        laneSlots.push_back(slots);
+    }
+    bool ok = Expect(perLane > 8, "%d slots per lane at gridW %d: the window path is never taken", perLane, kGridW);
+
+    // Frog columns: whole, half and off-by-epsilon tiles, and both screen edges
+    std::vector<float> frogXs = { -0.5f, 0.f, static_cast<float>(kGridW) - 1.f, static_cast<float>(kGridW) - 0.5f };
+    for (int x = 1; x < kGridW - 1; x += 17) {
+        frogXs.push_back(static_cast<float>(x));
+        frogXs.push_back(static_cast<float>(x) + 0.5f);
+        frogXs.push_back(static_cast<float>(x) + 1e-4f);
+    }
+
+    uint32_t rng = 0x9e3779b9u;
+    long visible = 0, hits = 0, probes = 0, wraps = 0;
+    for (size_t li = 0; li < lanes.size() && ok; ++li) {
+        Lane& ln = lanes[li];
+        const VehicleSlot* slots = laneSlots[li];
+        for (int step = 0; step < kSteps && ok; ++step) {
+            // Mostly frame-sized steps; loops are hundreds of tiles long, so the odd step of
+            // up to a minute sweeps far, wraps, or even passes a whole loop
+            const float dt = NextRand(rng) % 16 == 0 ? static_cast<float>(NextRand(rng) % 6000) / 100.f
+                                                     : static_cast<float>(NextRand(rng) % 40 + 1) / 1200.f;
+            const float scale = 1.f + static_cast<float>(NextRand(rng) % 200) / 100.f;
+            const float before = ln.Phase();
+            ln.Update(dt, scale);
+            wraps += ln.Phase() < before;
+            const float advance = ln.CurrentSpeed(scale) * dt;
+
+            const std::vector<float> expect = VisibleFullScan(ln, slots);
+            std::vector<float> got;
+            ln.ForEachVisibleVehicle(kGridW, kScreenRow, [&](const TileRect& r) { got.push_back(r.x); });
+            const std::vector<float> gotAs = ln.Dir() == Direction::Right ? VisibleAs<Direction::Right>(ln)
+                                                                          : VisibleAs<Direction::Left>(ln);
+            ok &= Expect(got == expect && gotAs == expect,
+                         "lane %zu step %d phase %.4f: %zu / %zu visible, full scan sees %zu",
+                         li, step, ln.Phase(), got.size(), gotAs.size(), expect.size());
+            visible += static_cast<long>(expect.size());
+
+            for (float fx : frogXs) {
+                const TileRect frog{ fx, static_cast<float>(kScreenRow), 1.f, 1.f };
+                const bool hit = ln.CollidesAtScreenRow(frog, kGridW, kScreenRow);
+                const bool full = CollidesFullScan(ln, slots, advance, frog);
+                ok &= Expect(hit == full, "lane %zu step %d phase %.4f advance %.4f, frog at %.4f: window %d, full scan %d",
+                             li, step, ln.Phase(), advance, fx, hit, full);
+                hits += full;
+                ++probes;
+            }
+        }
+    }
+    std::printf("lane window %d wide: %zu loop lanes x %d steps (%ld wraps), %ld visible vehicles, "
+                "%ld / %ld probes hit: %s\n", kGridW, lanes.size(), kSteps, wraps, visible, hits, probes,
+                ok ? "same as full scans" : "differ");
+    ok &= Expect(hits > 0 && hits < probes && wraps > 0, "the probes never hit, never missed or never wrapped");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+// Lane prefetch on scroll (ctest: prefetch).
+//
+// Plays one game that tops up its lane ring with PrefetchStep() after every tick, as the
+// sim workers do in idle time, and one that never prefetches, with the same inputs.
+// Every scroll of the first must be all hits. The second uses up the lanes pregenerated
+// at reset, then generates inline (misses). Both must show the same lanes and the same
+// lockstep hash on every tick, and the counters must add up.
+#include <cstdio>
+#include "game.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace test_util;
+
+const SDL_Color kGreen{0, 255, 0, 255};
+constexpr int kTicks = 30000;
+constexpr int kShift = 7;          // rows per scroll
+constexpr int kPregenTarget = 14;  // lanes pregenerated above the window
+
+// Hit / miss counts of a game that never prefetches, after 'scrolls' scrolls
+void ExpectedWithoutPrefetch(int gridH, int scrolls, int& hits, int& misses) {
+    int ringSize = gridH + kPregenTarget;
+    hits = misses = 0;
+    for (int s = 0; s < scrolls; ++s) {
+        const int ready = ringSize - gridH < kShift ? ringSize - gridH : kShift;
+        hits += ready;
+        ringSize -= kShift;
+        if (ringSize < gridH) {
+            misses += gridH - ringSize;
+            ringSize = gridH;
+        }
+    }
+}
+
+bool SameLanes(const Game& a, const Game& b) {
+    for (int y = 0; y < a.GridH(); ++y) {
+        if (a.LaneAtRow(y).WorldRow() != b.LaneAtRow(y).WorldRow() ||
+            a.LaneAtRow(y).Fingerprint() != b.LaneAtRow(y).Fingerprint()) return false;
+    }
+    return true;
+}
+
+bool PrefetchedMatchesInline(bool streamLanes) {
+    Game prefetched(15), inlined(15);
+    prefetched.SetStreamLanes(streamLanes);
+    inlined.SetStreamLanes(streamLanes);
+    prefetched.ResetWithSeed("1234567890", kGreen, 7);
+    inlined.ResetWithSeed("1234567890", kGreen, 7);
+    bool ok = Expect(!prefetched.PrefetchStep(), "the ring is not full after reset");
+
+    uint32_t rng = 0x9e3779b9u;
+    int matches = 1, mostScrolls = 0, totalMisses = 0;
+    auto checkCounters = [&](int t) {
+        const int scrolls = inlined.LanesAdvanced() / kShift;
+        int hits = 0, misses = 0;
+        ExpectedWithoutPrefetch(inlined.GridH(), scrolls, hits, misses);
+        mostScrolls = scrolls > mostScrolls ? scrolls : mostScrolls;
+        ok &= Expect(prefetched.PrefetchHits() == scrolls * kShift && prefetched.PrefetchMisses() == 0,
+                     "tick %d, %d scrolls: prefetched game has %d hits %d misses, expected %d / 0",
+                     t, scrolls, prefetched.PrefetchHits(), prefetched.PrefetchMisses(), scrolls * kShift);
+        ok &= Expect(inlined.PrefetchHits() == hits && inlined.PrefetchMisses() == misses,
+                     "tick %d, %d scrolls: game without prefetch has %d hits %d misses, expected %d / %d",
+                     t, scrolls, inlined.PrefetchHits(), inlined.PrefetchMisses(), hits, misses);
+    };
+    for (int t = 0; t < kTicks && ok; ++t) {
+        if (inlined.IsGameOver()) {
+            checkCounters(t);
+            totalMisses += inlined.PrefetchMisses();
+            prefetched.ResetWithSeed("1234567890", kGreen, 7);
+            inlined.ResetWithSeed("1234567890", kGreen, 7);
+            ++matches;
+        }
+        InputAction action;
+        if (ScriptedInput(inlined, t, rng, action)) {
+            prefetched.HandleInput(action);
+            inlined.HandleInput(action);
+        }
+        prefetched.Update(kDt);
+        inlined.Update(kDt);
+        while (prefetched.PrefetchStep()) {}
+
+        ok &= Expect(prefetched.StateHash() == inlined.StateHash(), "tick %d: hashes differ", t);
+        ok &= Expect(SameLanes(prefetched, inlined), "tick %d: visible lanes differ", t);
+        checkCounters(t);
+    }
+    totalMisses += inlined.PrefetchMisses();
+    std::printf("prefetch%s: %d matches, up to %d scrolls, %d inline lanes without prefetch, lanes and hashes %s\n",
+                streamLanes ? " stream lanes" : "", matches, mostScrolls, totalMisses, ok ? "equal" : "differ");
+    // Two scrolls use up the pregenerated lanes; only the third generates inline
+    return ok & Expect(totalMisses > 0, "no match scrolled far enough to miss");
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok &= PrefetchedMatchesInline(false);
+    ok &= PrefetchedMatchesInline(true);
+    return ok ? 0 : 1;
+}
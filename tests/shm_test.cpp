@@ -0,0 +1,140 @@
+// Live-state export round trip (ctest: shm_export).
+//
+// Publishes games through ShmExporter and reads them back through ShmReader: header
+// fields, seqlocked player state and lane records (including a stream lane's kind).
+// Then covers a restart under the same name: a stale segment from a "crashed" run is
+// replaced through unlink + O_EXCL, a reader keeps its old mapping valid, the old
+// writer's exit doesn't unlink the new run's segment, and the new one's exit does.
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "shm_export.h"
+#include "shm_reader.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace test_util;
+
+const SDL_Color kGreen{0, 255, 0, 255};
+
+bool StateMatches(const ShmReader& reader, int player, const Game& game, const char* what) {
+    frogger_shm::PlayerState st{};
+    if (!Expect(reader.Read(player, st), "%s: player %d not readable", what, player)) return false;
+    bool ok = Expect(st.tick == game.Tick() && st.stateHash == game.StateHash(),
+                     "%s: tick %llu hash %llx, expected %llu / %llx", what,
+                     static_cast<unsigned long long>(st.tick), static_cast<unsigned long long>(st.stateHash),
+                     static_cast<unsigned long long>(game.Tick()), static_cast<unsigned long long>(game.StateHash()));
+    ok &= Expect(st.frogX == game.Player().GetX() && st.frogY == game.Player().GetY() && st.score == game.Score() &&
+                 st.bottomRowWorld == game.BottomRowWorld() && st.gameOver == (game.IsGameOver() ? 1 : 0),
+                 "%s: frog / score / scroll fields differ", what);
+    ok &= Expect(st.laneCount == game.GridH(), "%s: %d lanes, expected %d", what, st.laneCount, game.GridH());
+    for (int y = 0; y < st.laneCount && ok; ++y) {
+        const Lane& ln = game.LaneAtRow(y);
+        const frogger_shm::LaneRecord& lr = st.lanes[y];
+        const uint8_t kind = !ln.IsTraffic() ? frogger_shm::kSafe : (ln.IsStream() ? frogger_shm::kStream : frogger_shm::kLoop);
+        ok &= Expect(lr.worldRow == ln.WorldRow() && lr.kind == kind, "%s: lane %d is row %d kind %d, expected %d / %d",
+                     what, y, lr.worldRow, lr.kind, ln.WorldRow(), kind);
+        if (kind == frogger_shm::kLoop) {
+            ok &= Expect(lr.phase == ln.Phase() && lr.loopLen == ln.LoopLenTiles() && lr.phase >= 0.f && lr.phase < lr.loopLen,
+                         "%s: lane %d phase %.3f / %.3f", what, y, lr.phase, lr.loopLen);
+        } else {
+            ok &= Expect(lr.phase == 0.f && lr.loopLen == 1.f, "%s: non-loop lane %d exports phase %.3f", what, y, lr.phase);
+        }
+    }
+    return ok;
+}
+
+bool RoundTrip(const std::string& name) {
+    Game a(15), b(15);
+    b.SetStreamLanes(true);
+    a.ResetWithSeed("1234567890", kGreen, 7);
+    b.ResetWithSeed("1234567890", kGreen, 7);
+
+    ShmExporter exporter(name, 2, 15, 9, 60);
+    if (!Expect(exporter.IsOk(), "exporter for %s failed", name.c_str())) return false;
+    exporter.BeginSession("1234567890");
+    ShmReader reader;
+    if (!Expect(reader.Open(name), "reader cannot open %s", name.c_str())) return false;
+    bool ok = Expect(reader.PlayerCount() == 2 && reader.GridW() == 15 && reader.GridH() == 9 && reader.SimHz() == 60,
+                     "header: %d players %dx%d @%d", reader.PlayerCount(), reader.GridW(), reader.GridH(), reader.SimHz());
+    ok &= Expect(reader.Seed() == "1234567890" && reader.Session() == 1 && !reader.WriterClosed(),
+                 "seed '%s' session %u", reader.Seed().c_str(), reader.Session());
+    frogger_shm::PlayerState st{};
+    ok &= Expect(!reader.Read(0, st), "a never-published record reads as valid");
+
+    bool sawStream = false;
+    for (int t = 0; t < 600 && ok; ++t) {
+        if (t % 30 == 0) {
+            a.HandleInput(InputAction::Up);
+            b.HandleInput(InputAction::Up);
+        }
+        a.Update(kDt);
+        b.Update(kDt);
+        exporter.Publish(0, a);
+        exporter.Publish(1, b);
+        ok &= StateMatches(reader, 0, a, "loop lanes");
+        ok &= StateMatches(reader, 1, b, "stream lanes");
+        for (int y = 0; y < b.GridH(); ++y) sawStream |= b.LaneAtRow(y).IsStream();
+    }
+    ok &= Expect(sawStream, "the stream-lane game never showed a stream lane");
+    std::printf("shm round trip: header, seqlocked state and lane records %s\n", ok ? "match" : "differ");
+    return ok;
+}
+
+bool Restart(const std::string& name) {
+    // A crashed run's leftover: wrong size, never initialized
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    bool ok = Expect(fd >= 0 && ftruncate(fd, 100) == 0, "cannot create the stale segment");
+    if (fd >= 0) close(fd);
+    ShmReader stale;
+    ok &= Expect(!stale.Open(name), "reader accepted an uninitialized segment");
+
+    Game game(15);
+    game.ResetWithSeed("1234567890", kGreen, 7);
+    game.Update(kDt);
+
+    auto first = std::make_unique<ShmExporter>(name, 1, 15, 9, 60);
+    ok &= Expect(first->IsOk(), "exporter did not replace the stale segment");
+    first->BeginSession("1234567890");
+    first->Publish(0, game);
+    ShmReader oldReader;
+    ok &= Expect(oldReader.Open(name) && oldReader.PlayerCount() == 1, "first run not readable");
+
+    // Next run under the same name, with more players, while the first is still alive
+    auto second = std::make_unique<ShmExporter>(name, 3, 15, 9, 60);
+    ok &= Expect(second->IsOk(), "second exporter failed to recreate the segment");
+    second->BeginSession("4242424242");
+    ok &= StateMatches(oldReader, 0, game, "old mapping after recreate");
+    ShmReader newReader;
+    ok &= Expect(newReader.Open(name) && newReader.PlayerCount() == 3 && newReader.Seed() == "4242424242",
+                 "second run not readable under the name");
+
+    first.reset();   // the old run exits: its readers learn so, the new segment survives
+    ok &= Expect(oldReader.WriterClosed(), "old reader not told its writer closed");
+    ok &= Expect(!newReader.WriterClosed(), "new reader told its writer closed");
+    ShmReader again;
+    ok &= Expect(again.Open(name) && again.PlayerCount() == 3, "the old run's exit unlinked the new segment");
+
+    second.reset();
+    ShmReader gone;
+    ok &= Expect(!gone.Open(name), "segment still linked after its writer exited");
+    ok &= Expect(newReader.WriterClosed(), "new reader not told its writer closed");
+    std::printf("shm restart: stale segment replaced, old mapping intact, unlink only by the owner: %s\n",
+                ok ? "ok" : "failed");
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    const std::string name = "/frogger_test_" + std::to_string(getpid());
+    bool ok = true;
+    ok &= RoundTrip(name);
+    ok &= Restart(name);
+    shm_unlink(name.c_str());
+    return ok ? 0 : 1;
+}
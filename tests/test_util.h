@@ -0,0 +1,54 @@
+#pragma once
+// Small helpers shared by the headless tests. Each test is a plain executable that
+// prints what it checked and returns non-zero on the first report of a failure.
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include "game.h"
+
+namespace test_util {
+
+constexpr float kDt = 1.0f / 60.0f;
+
+inline uint32_t NextRand(uint32_t& x) {
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return x;
+}
+
+// Prints "FAIL: <message>" when 'cond' is false; returns 'cond' so callers can fold
+// results with ok &= Expect(...)
+inline bool Expect(bool cond, const char* fmt, ...) {
+    if (cond) return true;
+    std::va_list args;
+    va_start(args, fmt);
+    std::printf("FAIL: ");
+    std::vprintf(fmt, args);
+    std::printf("\n");
+    va_end(args);
+    return false;
+}
+
+// True if no vehicle is within 'margin' tiles of the frog's column on the row above it
+inline bool RowAboveClear(const Game& game, float margin) {
+    const float x = static_cast<float>(game.Player().GetX());
+    const float y = static_cast<float>(game.Player().GetY() + 1);
+    bool clear = true;
+    game.ForEachVehicle([&](const TileRect& r) {
+        if (r.y == y && r.x < x + 1.0f + margin && r.x + r.w > x - margin) clear = false;
+    });
+    return clear;
+}
+
+// A scripted player: hops up into gaps every few ticks so matches scroll, with the odd
+// sideways hop. Returns false on ticks without input. The same 'rng' stream gives the
+// same inputs to games in the same state.
+inline bool ScriptedInput(const Game& game, int tick, uint32_t& rng, InputAction& action) {
+    const uint32_t r = NextRand(rng) % 40;
+    if (tick % 6 == 0 && RowAboveClear(game, 1.5f)) action = InputAction::Up;
+    else if (r == 0) action = InputAction::Left;
+    else if (r == 1) action = InputAction::Right;
+    else return false;
+    return true;
+}
+
+} // namespace test_util
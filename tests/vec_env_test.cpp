@@ -0,0 +1,178 @@
+// VecEnv against hand-stepped Games (ctest: vec_env).
+//
+// Each env of a fixed-map VecEnv is shadowed by a plain Game fed the same actions and
+// reset on the same steps. Every step checks the observation layout (W*H occupancy
+// bytes, then little-endian uint16 frog x and y), the reward and the done flag.
+// Also checks grid clamping and that a fixed map without a seed stays fixed.
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "test_util.h"
+#include "vec_env.h"
+
+namespace {
+
+using namespace test_util;
+
+EnvAction ToEnvAction(InputAction a) {
+    switch (a) {
+        case InputAction::Up:    return EnvAction::Up;
+        case InputAction::Down:  return EnvAction::Down;
+        case InputAction::Left:  return EnvAction::Left;
+        case InputAction::Right: return EnvAction::Right;
+    }
+    return EnvAction::Noop;
+}
+
+// Expected observation of 'game', built from the vehicle rectangles independently of
+// VecEnv: a tile is occupied if any vehicle overlaps it at all
+bool ObsMatches(const Game& game, const uint8_t* obs, int W, int H, int env, int step) {
+    std::vector<uint8_t> expect(static_cast<size_t>(W * H), 0);
+    game.ForEachVehicle([&](const TileRect& r) {
+        for (int x = 0; x < W; ++x) {
+            if (r.x < static_cast<float>(x + 1) && r.x + r.w > static_cast<float>(x)) {
+                expect[static_cast<size_t>(static_cast<int>(r.y) * W + x)] = 1;
+            }
+        }
+    });
+    for (int i = 0; i < W * H; ++i) {
+        if (obs[i] != expect[static_cast<size_t>(i)]) {
+            return Expect(false, "env %d step %d: occupancy of tile (%d, %d) is %d, expected %d",
+                          env, step, i % W, i / W, obs[i], expect[static_cast<size_t>(i)]);
+        }
+    }
+    const int frogX = obs[W * H] | (obs[W * H + 1] << 8);
+    const int frogY = obs[W * H + 2] | (obs[W * H + 3] << 8);
+    return Expect(frogX == game.Player().GetX() && frogY == game.Player().GetY(),
+                  "env %d step %d: frog (%d, %d) in obs, (%d, %d) in game",
+                  env, step, frogX, frogY, game.Player().GetX(), game.Player().GetY());
+}
+
+bool MatchesHandStepped(int gridW, bool streamLanes) {
+    VecEnvConfig cfg;
+    cfg.numEnvs = 4;
+    cfg.threads = 2;
+    cfg.gridW = gridW;
+    cfg.seed = "1234567890";
+    cfg.varyMaps = false;
+    cfg.maxEpisodeSteps = 1500;
+    cfg.streamLanes = streamLanes;
+    VecEnv env(cfg);
+    const int W = gridW, H = cfg.gridH;
+    const size_t n = static_cast<size_t>(env.NumEnvs());
+    const size_t obsSize = static_cast<size_t>(env.ObsSize());
+    bool ok = Expect(env.ObsSize() == W * H + 4, "ObsSize %d, expected %d", env.ObsSize(), W * H + 4);
+
+    const SDL_Color green{0, 255, 0, 255};
+    std::vector<std::unique_ptr<Game>> games;
+    std::vector<int> lastScore(n, 0), episodeSteps(n, 0);
+    std::vector<uint32_t> rngs;
+    for (size_t i = 0; i < n; ++i) {
+        games.push_back(std::make_unique<Game>(W, H));
+        games.back()->SetStreamLanes(streamLanes);
+        games.back()->ResetWithSeed(cfg.seed, green, W / 2);
+        rngs.push_back(0x9e3779b9u + static_cast<uint32_t>(i));
+    }
+
+    std::vector<uint8_t> obs(n * obsSize), dones(n);
+    std::vector<float> rewards(n);
+    std::vector<EnvAction> actions(n);
+    env.Reset(obs.data());
+    for (size_t i = 0; i < n && ok; ++i) ok &= ObsMatches(*games[i], obs.data() + i * obsSize, W, H, static_cast<int>(i), 0);
+
+    int episodes = 0, rewarded = 0;
+    for (int t = 1; t <= 6000 && ok; ++t) {
+        for (size_t i = 0; i < n; ++i) {
+            InputAction a;
+            actions[i] = ScriptedInput(*games[i], t, rngs[i], a) ? ToEnvAction(a) : EnvAction::Noop;
+        }
+        env.Step(actions.data(), obs.data(), rewards.data(), dones.data());
+        // Replay the same actions on the hand-stepped games
+        for (size_t i = 0; i < n && ok; ++i) {
+            Game& g = *games[i];
+            switch (actions[i]) {
+                case EnvAction::Noop:  break;
+                case EnvAction::Up:    g.HandleInput(InputAction::Up);    break;
+                case EnvAction::Down:  g.HandleInput(InputAction::Down);  break;
+                case EnvAction::Left:  g.HandleInput(InputAction::Left);  break;
+                case EnvAction::Right: g.HandleInput(InputAction::Right); break;
+            }
+            g.Update(1.0f / static_cast<float>(cfg.simHz));
+            const float reward = static_cast<float>(g.Score() - lastScore[i]);
+            lastScore[i] = g.Score();
+            const bool done = g.IsGameOver() || ++episodeSteps[i] >= cfg.maxEpisodeSteps;
+            ok &= Expect(rewards[i] == reward, "env %zu step %d: reward %.0f, expected %.0f", i, t, rewards[i], reward);
+            ok &= Expect(dones[i] == (done ? 1 : 0), "env %zu step %d: done %d, expected %d", i, t, dones[i], done);
+            rewarded += reward != 0.f;
+            if (done) {
+                g.ResetWithSeed(cfg.seed, green, W / 2);
+                lastScore[i] = g.Score();
+                episodeSteps[i] = 0;
+                ++episodes;
+            }
+            ok &= ObsMatches(g, obs.data() + i * obsSize, W, H, static_cast<int>(i), t);
+        }
+    }
+    std::printf("vec env %d wide%s: %d episodes, %d rewarded steps, obs/reward/done %s\n",
+                gridW, streamLanes ? " stream lanes" : "", episodes, rewarded, ok ? "match" : "differ");
+    ok &= Expect(episodes > 0 && rewarded > 0, "no episode ended or no reward was paid");
+    return ok;
+}
+
+bool GridClamped() {
+    bool ok = true;
+    for (int h : { -3, 0, 7, 100000 }) {
+        VecEnvConfig cfg;
+        cfg.numEnvs = 2;
+        cfg.threads = 1;
+        cfg.gridH = h;
+        cfg.seed = "1234567890";
+        VecEnv env(cfg);
+        const int expectH = h < 8 ? 8 : 64;
+        std::vector<uint8_t> obs(2 * static_cast<size_t>(env.ObsSize()));
+        env.Reset(obs.data());
+        ok &= Expect(env.ObsSize() == 15 * expectH + 4 && env.EnvGame(0).GridH() == expectH,
+                     "gridH %d: obs %d bytes, game %d rows; expected %d rows", h, env.ObsSize(),
+                     env.EnvGame(0).GridH(), expectH);
+    }
+    std::printf("vec env grid clamping %s\n", ok ? "ok" : "wrong");
+    return ok;
+}
+
+// varyMaps off and no seed: one map drawn at construction, replayed by every env and episode
+bool UnseededFixedMapStaysFixed() {
+    VecEnvConfig cfg;
+    cfg.numEnvs = 3;
+    cfg.threads = 1;
+    cfg.varyMaps = false;
+    cfg.maxEpisodeSteps = 10;
+    VecEnv env(cfg);
+    std::vector<uint8_t> obs(3 * static_cast<size_t>(env.ObsSize())), dones(3);
+    std::vector<float> rewards(3);
+    std::vector<EnvAction> actions(3, EnvAction::Noop);
+    env.Reset(obs.data());
+    const std::string map = env.EnvGame(0).NormalizedSeed();
+    bool ok = true;
+    for (int t = 0; t < 50; ++t) {
+        env.Step(actions.data(), obs.data(), rewards.data(), dones.data());
+        for (int i = 0; i < 3; ++i) {
+            ok &= Expect(env.EnvGame(i).NormalizedSeed() == map, "env %d step %d plays map %s, expected %s",
+                         i, t, env.EnvGame(i).NormalizedSeed().c_str(), map.c_str());
+        }
+    }
+    std::printf("vec env unseeded fixed map %s over %llu episodes: %s\n", map.c_str(),
+                static_cast<unsigned long long>(env.Episodes()), ok ? "fixed" : "changed");
+    return ok & Expect(env.Episodes() >= 12, "episodes were not truncated");
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok &= MatchesHandStepped(15, false);
+    ok &= MatchesHandStepped(600, true);   // frog x over 255 needs the high byte
+    ok &= GridClamped();
+    ok &= UnseededFixedMapStaysFixed();
+    return ok ? 0 : 1;
+}